@@ -0,0 +1,145 @@
+#ifndef CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_CLIENT_HPP_
+#define CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_CLIENT_HPP_
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "custom_interfaces/action/circle_wall_v2.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "wall_follower_core/future_stream.hpp"
+
+// Client of move_robot_v2 whose calls never block: each returns futures that
+// complete from callbacks on whatever executor spins the node, so a caller
+// can wait on them with spin_until_future_complete and a timeout.
+class CircleWallActionClient : public rclcpp::Node
+{
+public:
+  using CircleWall = custom_interfaces::action::CircleWallV2;
+  using GoalHandleCircleWall = rclcpp_action::ClientGoalHandle<CircleWall>;
+  using Feedback = std::shared_ptr<const CircleWall::Feedback>;
+  using FeedbackStream = wall_follower::FutureStream<Feedback>;
+  using WrappedResult = GoalHandleCircleWall::WrappedResult;
+  using CancelResponse = rclcpp_action::Client<CircleWall>::CancelResponse;
+
+  // accepted completes with the goal handle, or nullptr when the server
+  // rejected the goal, in which case result completes at once with
+  // ResultCode::UNKNOWN. The feedback stream ends (a nullptr) once result
+  // is set.
+  struct GoalFutures
+  {
+    std::shared_future<GoalHandleCircleWall::SharedPtr> accepted;
+    std::shared_ptr<FeedbackStream> feedback;
+    std::shared_future<WrappedResult> result;
+  };
+
+  explicit CircleWallActionClient(const rclcpp::NodeOptions & node_options = rclcpp::NodeOptions())
+  : Node("circle_wall_action_client", node_options)
+  {
+    this->client_ptr_ = rclcpp_action::create_client<CircleWall>(this, "move_robot_v2");
+  }
+
+  // Completes with true once the server is discovered, or false after
+  // timeout. Discovery is polled from a timer instead of waiting in
+  // wait_for_action_server, which would hold an executor thread.
+  std::shared_future<bool> server_ready(std::chrono::nanoseconds timeout)
+  {
+    std::promise<bool> promise;
+    auto future = promise.get_future().share();
+    if (this->client_ptr_->action_server_is_ready()) {
+      promise.set_value(true);
+      return future;
+    }
+    std::lock_guard<std::mutex> lock(discovery_mutex_);
+    discovery_.push_back({std::move(promise), std::chrono::steady_clock::now() + timeout});
+    if (!discovery_timer_) {
+      // wall time: under use_sim_time there may be no /clock before the server is up
+      discovery_timer_ = this->create_wall_timer(
+        std::chrono::milliseconds(50), std::bind(&CircleWallActionClient::poll_server, this));
+    }
+    return future;
+  }
+
+  // Send only after server_ready() completed with true; a request sent before
+  // discovery can be lost, leaving accepted pending forever.
+  GoalFutures send_goal(const CircleWall::Goal & goal)
+  {
+    auto accepted = std::make_shared<std::promise<GoalHandleCircleWall::SharedPtr>>();
+    auto result = std::make_shared<std::promise<WrappedResult>>();
+    auto feedback = std::make_shared<FeedbackStream>();
+    GoalFutures futures{accepted->get_future().share(), feedback, result->get_future().share()};
+
+    auto options = rclcpp_action::Client<CircleWall>::SendGoalOptions();
+    options.goal_response_callback =
+      [accepted, result, feedback](const GoalHandleCircleWall::SharedPtr & goal_handle) {
+        accepted->set_value(goal_handle);
+        if (!goal_handle) {
+          WrappedResult rejected;
+          rejected.code = rclcpp_action::ResultCode::UNKNOWN;
+          result->set_value(rejected);
+          feedback->close();
+        }
+      };
+    options.feedback_callback =
+      [feedback](GoalHandleCircleWall::SharedPtr, const Feedback message) {
+        feedback->push(message);
+      };
+    // result first, so a caller that sees the stream end can read it at once
+    options.result_callback = [result, feedback](const WrappedResult & wrapped) {
+        result->set_value(wrapped);
+        feedback->close();
+      };
+    this->client_ptr_->async_send_goal(goal, options);
+    return futures;
+  }
+
+  // Completes with the server's answer, or nullptr when the goal is already
+  // finished and unknown to the client.
+  std::shared_future<CancelResponse::SharedPtr> cancel(
+    const GoalHandleCircleWall::SharedPtr & goal_handle)
+  {
+    try {
+      return this->client_ptr_->async_cancel_goal(goal_handle);
+    } catch (const rclcpp_action::exceptions::UnknownGoalHandleError &) {
+      std::promise<CancelResponse::SharedPtr> done;
+      done.set_value(nullptr);
+      return done.get_future().share();
+    }
+  }
+
+private:
+  struct Discovery
+  {
+    std::promise<bool> promise;
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+  rclcpp_action::Client<CircleWall>::SharedPtr client_ptr_;
+  std::mutex discovery_mutex_;
+  std::vector<Discovery> discovery_;
+  rclcpp::TimerBase::SharedPtr discovery_timer_;
+
+  void poll_server()
+  {
+    const bool ready = this->client_ptr_->action_server_is_ready();
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(discovery_mutex_);
+    for (auto it = discovery_.begin(); it != discovery_.end(); ) {
+      if (ready || now >= it->deadline) {
+        it->promise.set_value(ready);
+        it = discovery_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (discovery_.empty()) {
+      discovery_timer_->cancel();
+      discovery_timer_.reset();
+    }
+  }
+};
+
+#endif  // CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_CLIENT_HPP_
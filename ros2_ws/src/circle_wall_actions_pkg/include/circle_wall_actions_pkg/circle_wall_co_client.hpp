@@ -0,0 +1,205 @@
+#ifndef CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_CO_CLIENT_HPP_
+#define CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_CO_CLIENT_HPP_
+
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <string>
+#include <utility>
+#include "custom_interfaces/action/circle_wall_v2.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "wall_follower_core/awaitable.hpp"
+
+// Awaitable adaptor over rclcpp_action::Client<CircleWallV2> for C++20
+// coroutines, e.g. inside a wall_follower::Task<bool>:
+//
+//   if (!co_await client.server_ready(10s)) co_return false;
+//   auto goal = co_await client.send_goal(request);
+//   while (auto feedback = co_await goal->next_feedback()) { ... }
+//   auto result = co_await goal->result();
+//
+// Nothing blocks: a suspended coroutine holds no thread and is resumed from
+// the action client's callbacks on the executor spinning `node`, so any
+// number of missions can share one single-threaded executor.
+class CircleWallCoClient
+{
+public:
+  using CircleWall = custom_interfaces::action::CircleWallV2;
+  using GoalHandleCircleWall = rclcpp_action::ClientGoalHandle<CircleWall>;
+  using Feedback = std::shared_ptr<const CircleWall::Feedback>;
+  using WrappedResult = GoalHandleCircleWall::WrappedResult;
+
+  // One goal sent by send_goal().
+  class Goal
+  {
+  public:
+    // The next feedback message, or nullptr once the goal has finished.
+    auto next_feedback() {return feedback_.next();}
+
+    // Resumes once the server reports the outcome.
+    auto result() {return result_.operator co_await();}
+
+    // The answer comes back as a CANCELED (or other final) result. The
+    // request goes out from a one-shot timer: a coroutine resumed by
+    // next_feedback() runs inside the client's feedback callback, which holds
+    // the lock async_cancel_goal takes.
+    void cancel()
+    {
+      if (cancel_timer_) {
+        return;
+      }
+      cancel_timer_ = node_->create_wall_timer(
+        std::chrono::nanoseconds(0), [this]() {
+          cancel_timer_->cancel();
+          try {
+            client_->async_cancel_goal(handle_);
+          } catch (const rclcpp_action::exceptions::UnknownGoalHandleError &) {
+            // already finished
+          }
+        });
+    }
+
+    // Gives up on the goal after `timeout` of wall time: a cancel request goes
+    // to the server and result() resumes at once with CANCELED, without
+    // waiting for an answer that may never come. A no-op once it finished.
+    void expire_after(std::chrono::nanoseconds timeout)
+    {
+      expiry_timer_ = node_->create_wall_timer(
+        timeout, [this]() {
+          expiry_timer_->cancel();
+          if (result_.ready()) {
+            return;
+          }
+          expired_ = true;
+          try {
+            // a timer callback, so the feedback lock is not held here
+            client_->async_cancel_goal(handle_);
+          } catch (const rclcpp_action::exceptions::UnknownGoalHandleError &) {
+            // already finished
+          }
+          WrappedResult wrapped;
+          wrapped.goal_id = handle_->get_goal_id();
+          wrapped.code = rclcpp_action::ResultCode::CANCELED;
+          feedback_.close();
+          // last: the resumed coroutine may release this goal
+          result_.set(wrapped);
+        });
+    }
+
+    // True when expire_after() ended the goal.
+    bool expired() const {return expired_;}
+
+    const GoalHandleCircleWall::SharedPtr & handle() const {return handle_;}
+
+  private:
+    friend class CircleWallCoClient;
+
+    rclcpp::Node * node_ = nullptr;
+    rclcpp_action::Client<CircleWall>::SharedPtr client_;
+    GoalHandleCircleWall::SharedPtr handle_;
+    rclcpp::TimerBase::SharedPtr cancel_timer_;
+    rclcpp::TimerBase::SharedPtr expiry_timer_;
+    bool expired_ = false;
+    wall_follower::AwaitableValue<bool> accepted_;
+    wall_follower::AwaitableQueue<Feedback> feedback_;
+    wall_follower::AwaitableValue<WrappedResult> result_;
+  };
+
+  // Keeps the state alive for as long as the awaiting coroutine needs it.
+  template<typename Value, typename Resume>
+  struct Awaiter
+  {
+    std::shared_ptr<Value> value;
+    Resume resume;
+    typename wall_follower::AwaitableValue<bool>::Awaiter inner;
+
+    bool await_ready() const {return inner.await_ready();}
+    bool await_suspend(std::coroutine_handle<> waiter) {return inner.await_suspend(waiter);}
+    auto await_resume() {return resume(value, inner.await_resume());}
+  };
+
+  CircleWallCoClient(rclcpp::Node & node, const std::string & action_name = "move_robot_v2")
+  : node_(node),
+    client_(rclcpp_action::create_client<CircleWall>(&node, action_name))
+  {
+  }
+
+  // Resumes with true once the server is discovered, or false after timeout.
+  // Discovery is polled from a wall timer: under use_sim_time there may be no
+  // /clock before the server is up.
+  auto server_ready(std::chrono::nanoseconds timeout)
+  {
+    struct Discovery
+    {
+      wall_follower::AwaitableValue<bool> ready;
+      rclcpp::TimerBase::SharedPtr timer;
+    };
+    auto discovery = std::make_shared<Discovery>();
+    if (client_->action_server_is_ready()) {
+      discovery->ready.set(true);
+    } else {
+      const auto deadline = std::chrono::steady_clock::now() + timeout;
+      std::weak_ptr<Discovery> weak = discovery;
+      discovery->timer = node_.create_wall_timer(
+        std::chrono::milliseconds(50), [client = client_, weak, deadline]() {
+          auto discovery = weak.lock();
+          if (!discovery) {
+            return;
+          }
+          const bool ready = client->action_server_is_ready();
+          if (ready || std::chrono::steady_clock::now() >= deadline) {
+            discovery->timer->cancel();
+            // may run the awaiting coroutine to its next suspension
+            discovery->ready.set(ready);
+          }
+        });
+    }
+    auto resume = [](const std::shared_ptr<Discovery> &, bool ready) {return ready;};
+    return Awaiter<Discovery, decltype(resume)>{
+      discovery, resume, discovery->ready.operator co_await()};
+  }
+
+  // Resumes with the accepted goal, or nullptr when the server rejected it.
+  // Await server_ready() first: a request sent before discovery can be lost.
+  auto send_goal(const CircleWall::Goal & request)
+  {
+    auto goal = std::make_shared<Goal>();
+    goal->node_ = &node_;
+    goal->client_ = client_;
+    std::weak_ptr<Goal> weak = goal;
+    auto options = rclcpp_action::Client<CircleWall>::SendGoalOptions();
+    options.goal_response_callback = [weak](const GoalHandleCircleWall::SharedPtr & handle) {
+        if (auto goal = weak.lock()) {
+          goal->handle_ = handle;
+          if (!handle) {
+            goal->feedback_.close();
+          }
+          goal->accepted_.set(handle != nullptr);
+        }
+      };
+    options.feedback_callback = [weak](GoalHandleCircleWall::SharedPtr, const Feedback message) {
+        if (auto goal = weak.lock()) {
+          goal->feedback_.push(message);
+        }
+      };
+    // result first, so a coroutine that sees the feedback end can read it at once
+    options.result_callback = [weak](const WrappedResult & wrapped) {
+        if (auto goal = weak.lock()) {
+          goal->result_.set(wrapped);
+          goal->feedback_.close();
+        }
+      };
+    client_->async_send_goal(request, options);
+    auto resume = [](const std::shared_ptr<Goal> & goal, bool accepted) {
+        return accepted ? goal : std::shared_ptr<Goal>();
+      };
+    return Awaiter<Goal, decltype(resume)>{goal, resume, goal->accepted_.operator co_await()};
+  }
+
+private:
+  rclcpp::Node & node_;
+  rclcpp_action::Client<CircleWall>::SharedPtr client_;
+};
+
+#endif  // CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_CO_CLIENT_HPP_
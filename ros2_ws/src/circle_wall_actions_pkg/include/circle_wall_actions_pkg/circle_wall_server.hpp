@@ -0,0 +1,860 @@
+#ifndef CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_SERVER_HPP_
+#define CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_SERVER_HPP_
+
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "lifecycle_msgs/msg/state.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
+#include "custom_interfaces/action/circle_wall.hpp"
+#include "custom_interfaces/action/circle_wall_v2.hpp"
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "std_msgs/msg/bool.hpp"
+#include "wall_follower_core/config_fields.hpp"
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/goal_executor.hpp"
+#include "wall_follower_core/goal_runs.hpp"
+#include "wall_follower_core/latency_histogram.hpp"
+#include "wall_follower_core/latest_mailbox.hpp"
+#include "wall_follower_core/seqlock.hpp"
+#include <chrono>
+#include <iostream>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+// Lifecycle node: configure creates the publishers, subscriptions and action
+// servers, activate arms the controller from APPROACH and deactivate stops the
+// robot and ends its goals, so a run is reset in milliseconds instead of by
+// restarting the process.
+class CircleWallActionServer : public rclcpp_lifecycle::LifecycleNode
+{
+public:
+    using Circle = custom_interfaces::action::CircleWall;
+    using CircleV2 = custom_interfaces::action::CircleWallV2;
+
+    using GoalHandleCircleWall = rclcpp_action::ServerGoalHandle<Circle>;
+    using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
+
+    explicit CircleWallActionServer(const rclcpp::NodeOptions & options = rclcpp::NodeOptions())
+    : CircleWallActionServer("", options)
+    {
+    }
+
+    // One robot of a fleet hosted in a single process: every topic and action
+    // name is relative, so namespace "robot3" serves /robot3/lidar,
+    // /robot3/cmd_vel, /robot3/move_robot and so on.
+    explicit CircleWallActionServer(
+        const std::string & node_namespace,
+        const rclcpp::NodeOptions & options = rclcpp::NodeOptions())
+    : LifecycleNode("circle_wall_action_server", node_namespace, options)
+    {
+        // goals run on goal_workers pooled threads; goal_policy decides what a
+        // new goal does while they are all busy: reject, queue (up to
+        // goal_queue waiting goals) or preempt the running ones
+        const auto workers = this->declare_parameter<int64_t>("goal_workers", 1);
+        const auto queue = this->declare_parameter<int64_t>("goal_queue", 4);
+        const auto policy = this->declare_parameter("goal_policy", std::string("queue"));
+        if (workers < 1 || queue < 0 || !wall_follower::parse_goal_policy(policy, goal_policy_)) {
+            throw std::invalid_argument(
+                "goal_workers must be >= 1, goal_queue >= 0 and goal_policy reject, queue or preempt");
+        }
+        goal_executor_ = std::make_unique<wall_follower::GoalExecutor>(
+            static_cast<std::size_t>(workers), static_cast<std::size_t>(queue));
+        // feedback goes out on transitions, at most once per feedback_period_ms
+        feedback_period_ = std::chrono::milliseconds(
+            this->declare_parameter<int64_t>("feedback_period_ms", 100));
+        // callback_groups: lidar control, wall contact and action traffic get
+        // their own groups so a multi-threaded executor runs them in parallel;
+        // false puts everything in the node's default exclusive group
+        executor_threads_ = this->declare_parameter<int64_t>("executor_threads", 0);
+        if (this->declare_parameter("callback_groups", true)) {
+            control_group_ =
+                this->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+            safety_group_ = this->create_callback_group(rclcpp::CallbackGroupType::Reentrant);
+            action_group_ =
+                this->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive);
+        }
+        // latest_only: scans go through a single-slot mailbox and a control timer
+        // always steps on the freshest one, dropping any that went stale meanwhile
+        latest_only_ = this->declare_parameter("latest_only", false);
+        control_period_ = std::chrono::milliseconds(
+            this->declare_parameter<int64_t>("control_period_ms", 10));
+        stats_period_ = std::chrono::milliseconds(
+            this->declare_parameter<int64_t>("stats_period_ms", 1000));
+        declare_config();
+        // autostart: configure and activate right away, as a plain node would
+        // run; false leaves the node unconfigured for a lifecycle manager
+        if (this->declare_parameter("autostart", true)) {
+            if (this->configure().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_INACTIVE ||
+                this->activate().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE)
+            {
+                throw std::runtime_error("circle_wall_action_server failed to autostart");
+            }
+        }
+    }
+
+    ~CircleWallActionServer()
+    {
+        shutting_down_ = true;
+        preempt_goals();
+        wake_goals();
+        goal_executor_->shutdown();
+        if (scans_.dropped() > 0) {
+            RCLCPP_INFO(this->get_logger(), "Dropped %lu stale scans", scans_.dropped());
+        }
+        RCLCPP_INFO(this->get_logger(), "Scan latency: %s", latency_.to_string().c_str());
+        if (touch_to_stop_.count() > 0) {
+            RCLCPP_INFO(this->get_logger(), "Touch to stop latency: max %.1f us over %lu contacts",
+                static_cast<double>(touch_to_stop_.max()) / 1e3, touch_to_stop_.count());
+        }
+    }
+
+    // Threads for the MultiThreadedExecutor spinning this node, 0 for one per core.
+    size_t executor_threads() const
+    {
+        return static_cast<size_t>(std::max<int64_t>(executor_threads_, 0));
+    }
+
+    const wall_follower::LatencyStages & latency() const
+    {
+        return latency_;
+    }
+
+    // unconfigured -> inactive: everything the control loop and the action
+    // servers need is created here, once, so re-arming does not repeat it
+    CallbackReturn on_configure(const rclcpp_lifecycle::State &) override
+    {
+        using namespace std::placeholders;
+        this->action_server_ = rclcpp_action::create_server<Circle>(
+        this,
+        "move_robot",
+        std::bind(&CircleWallActionServer::handle_goal<Circle>, this, _1, _2),
+        std::bind(&CircleWallActionServer::handle_cancel<Circle>, this, _1),
+        std::bind(&CircleWallActionServer::handle_accepted<Circle>, this, _1),
+        rcl_action_server_get_default_options(), action_group_);
+        // same goals with fixed-size feedback and lap statistics in the result
+        this->action_server_v2_ = rclcpp_action::create_server<CircleV2>(
+        this,
+        "move_robot_v2",
+        std::bind(&CircleWallActionServer::handle_goal<CircleV2>, this, _1, _2),
+        std::bind(&CircleWallActionServer::handle_cancel<CircleV2>, this, _1),
+        std::bind(&CircleWallActionServer::handle_accepted<CircleV2>, this, _1),
+        rcl_action_server_get_default_options(), action_group_);
+        publisher_ = this->create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 10);
+        stats_publisher_ =
+            this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("diagnostics", 10);
+        stats_timer_ = rclcpp::create_timer(
+            this, this->get_clock(), stats_period_, std::bind(&CircleWallActionServer::publish_latency_stats, this),
+            action_group_);
+        rclcpp::SubscriptionOptions control_options;
+        control_options.callback_group = control_group_;
+        if (latest_only_) {
+            subscription1_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
+                "lidar", rclcpp::SensorDataQoS(),
+                std::bind(&CircleWallActionServer::mailbox_callback, this, _1), control_options);
+            // wall time: under sim time a lockstep clock only advances once a
+            // scan is answered, so a sim-clock timer would wait on itself
+            control_timer_ = this->create_wall_timer(
+                control_period_, std::bind(&CircleWallActionServer::control_timer_callback, this),
+                control_group_);
+        } else {
+            subscription1_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
+                "lidar", rclcpp::SensorDataQoS(),
+                std::bind(&CircleWallActionServer::lidar_callback, this, _1), control_options);
+        }
+        rclcpp::SubscriptionOptions safety_options;
+        safety_options.callback_group = safety_group_;
+        subscription2_ = this->create_subscription<std_msgs::msg::Bool>(
+            "wall/touched", 10, std::bind(&CircleWallActionServer::wall_callback, this, _1),
+            safety_options);
+        return CallbackReturn::SUCCESS;
+    }
+
+    // inactive -> active: re-arm. The controller restarts from APPROACH and a
+    // latched wall contact is cleared, without touching DDS.
+    CallbackReturn on_activate(const rclcpp_lifecycle::State &) override
+    {
+        halted_ = false;
+        end_requested_ = false;
+        reset_requested_ = true;
+        snapshot_.update(
+            [](wall_follower::ControllerSnapshot & s) {
+                s.state = State::APPROACH;
+                s.touched = false;
+                s.turns = 0;
+                s.circles = 0;
+            });
+        publisher_->on_activate();
+        stats_publisher_->on_activate();
+        active_ = true;
+        RCLCPP_INFO(this->get_logger(), "Armed");
+        return CallbackReturn::SUCCESS;
+    }
+
+    // active -> inactive: stop the robot, end every goal and ignore scans
+    // until the next activation.
+    CallbackReturn on_deactivate(const rclcpp_lifecycle::State &) override
+    {
+        disarm();
+        return CallbackReturn::SUCCESS;
+    }
+
+    CallbackReturn on_cleanup(const rclcpp_lifecycle::State &) override
+    {
+        release();
+        return CallbackReturn::SUCCESS;
+    }
+
+    CallbackReturn on_shutdown(const rclcpp_lifecycle::State &) override
+    {
+        disarm();
+        release();
+        return CallbackReturn::SUCCESS;
+    }
+
+private:
+
+    using State = wall_follower::State;
+
+    static_assert(
+        CircleV2::Feedback::STATE_APPROACH == static_cast<uint8_t>(State::APPROACH) &&
+        CircleV2::Feedback::STATE_TURN_RIGHT == static_cast<uint8_t>(State::TURN_RIGHT) &&
+        CircleV2::Feedback::STATE_MOVE_ALONG == static_cast<uint8_t>(State::MOVE_ALONG) &&
+        CircleV2::Feedback::STATE_TURN_LEFT_WALL == static_cast<uint8_t>(State::TURN_LEFT_WALL) &&
+        CircleV2::Feedback::STATE_ENDED == static_cast<uint8_t>(State::ENDED) &&
+        CircleV2::Feedback::STATE_TOUCHED_WALL == static_cast<uint8_t>(State::TOUCHED_WALL),
+        "CircleWallV2 state constants must match wall_follower::State");
+
+    // one per accepted goal, alive from acceptance until execute returns
+    struct GoalControl
+    {
+        const void * handle_id = nullptr;
+        std::atomic<bool> preempted{false};
+        std::atomic<bool> cancel_requested{false};
+    };
+
+    template<typename ActionT>
+    struct GoalContext : GoalControl
+    {
+        std::shared_ptr<rclcpp_action::ServerGoalHandle<ActionT>> handle;
+    };
+
+    // What a goal has done so far; filled into the feedback and result of
+    // whichever action version it came in on.
+    struct GoalProgress
+    {
+        wall_follower::ControllerSnapshot snapshot;
+        uint32_t turns = 0;
+        double elapsed = 0.0;
+        uint32_t laps = 0;
+        double lap_min = 0.0;
+        double lap_max = 0.0;
+        double lap_sum = 0.0;
+        uint8_t outcome = CircleV2::Result::OUTCOME_COMPLETED;
+    };
+
+    wall_follower::ScanAnalyzer analyzer_;
+    wall_follower::Seqlock<wall_follower::Config> config_;
+    // the control step's copy of config_, refreshed when its version moves
+    wall_follower::Config step_config_;
+    uint64_t step_config_version_ = 0;
+    rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr config_callback_;
+    wall_follower::ControllerState controller_;
+    wall_follower::TransitionStats transition_stats_;
+    wall_follower::LatestMailbox<sensor_msgs::msg::LaserScan::SharedPtr> scans_;
+    uint64_t reported_drops_ = 0;
+    rclcpp::TimerBase::SharedPtr control_timer_;
+    wall_follower::LatencyStages latency_;
+    rclcpp::TimerBase::SharedPtr stats_timer_;
+    rclcpp_lifecycle::LifecyclePublisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr stats_publisher_;
+    bool latest_only_ = false;
+    std::chrono::milliseconds control_period_{10};
+    std::chrono::milliseconds stats_period_{1000};
+    // set while the lifecycle state is active; callbacks do nothing otherwise
+    std::atomic<bool> active_{false};
+    // held by a control step from its active_ check to its publish, so disarm
+    // sends the last command before the publisher is deactivated
+    std::mutex step_mutex_;
+    // the control step starts over from a fresh ControllerState when set
+    std::atomic<bool> reset_requested_{false};
+
+    // Written by the control step after every scan and by wall_callback;
+    // goal threads and diagnostics read it without ever blocking either.
+    wall_follower::Seqlock<wall_follower::ControllerSnapshot> snapshot_;
+    // Safety stop: wall_callback publishes this preallocated zero command the
+    // moment contact is reported and latches halted_, after which the control
+    // step only ever commands TOUCHED_WALL (a halt).
+    const geometry_msgs::msg::Twist stop_command_{};
+    std::atomic<bool> halted_{false};
+    wall_follower::LatencyHistogram touch_to_stop_;
+    // set by the goal that finishes last so the control step ends the run;
+    // goal threads leave controller_ to the control step
+    std::atomic<bool> end_requested_{false};
+    wall_follower::GoalRuns goal_runs_;
+    // wake-up only: goal threads sleep on goal_event_ until event_seq_ moves
+    // (a transition) or their own goal is canceled/preempted
+    std::mutex event_mutex_;
+    std::condition_variable goal_event_;
+    uint64_t event_seq_ = 0;
+    std::chrono::milliseconds feedback_period_{100};
+
+    wall_follower::GoalPolicy goal_policy_ = wall_follower::GoalPolicy::QUEUE;
+    std::unique_ptr<wall_follower::GoalExecutor> goal_executor_;
+    std::mutex goals_mutex_;
+    std::vector<std::shared_ptr<GoalControl>> goals_;
+    std::condition_variable goals_changed_;
+    std::atomic<bool> shutting_down_{false};
+
+    int64_t executor_threads_ = 0;
+    rclcpp::CallbackGroup::SharedPtr control_group_;
+    rclcpp::CallbackGroup::SharedPtr safety_group_;
+    rclcpp::CallbackGroup::SharedPtr action_group_;
+    rclcpp_action::Server<Circle>::SharedPtr action_server_;
+    rclcpp_action::Server<CircleV2>::SharedPtr action_server_v2_;
+    rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::Twist>::SharedPtr publisher_;
+    const bool intra_process_ = this->get_node_options().use_intra_process_comms();
+    rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr subscription1_;
+    rclcpp::Subscription<std_msgs::msg::Bool>::SharedPtr subscription2_;
+
+    template<typename ActionT>
+    rclcpp_action::GoalResponse handle_goal(
+        const rclcpp_action::GoalUUID & uuid,
+        std::shared_ptr<const typename ActionT::Goal> goal)
+    {
+        RCLCPP_INFO(this->get_logger(), "Received goal request with %d circles around wall", goal->circles);
+        (void)uuid;
+        if (!active_) {
+            RCLCPP_WARN(this->get_logger(), "Rejecting goal: the controller is not active");
+            return rclcpp_action::GoalResponse::REJECT;
+        }
+        if (halted_) {
+            RCLCPP_WARN(this->get_logger(), "Rejecting goal: the robot touched the wall");
+            return rclcpp_action::GoalResponse::REJECT;
+        }
+        if ((goal_policy_ == wall_follower::GoalPolicy::REJECT && !goal_executor_->has_idle_worker()) ||
+            (goal_policy_ == wall_follower::GoalPolicy::QUEUE && goal_executor_->full()))
+        {
+            RCLCPP_WARN(this->get_logger(), "Rejecting goal: %zu running, %zu queued",
+                goal_executor_->running(), goal_executor_->queued());
+            return rclcpp_action::GoalResponse::REJECT;
+        }
+        return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+    }
+
+    template<typename ActionT>
+    rclcpp_action::CancelResponse handle_cancel(
+        const std::shared_ptr<rclcpp_action::ServerGoalHandle<ActionT>> goal_handle)
+    {
+        RCLCPP_INFO(this->get_logger(), "Action canceled.");
+        {
+            std::lock_guard<std::mutex> lock(goals_mutex_);
+            for (auto & context : goals_) {
+                if (context->handle_id == goal_handle.get()) {
+                    context->cancel_requested = true;
+                }
+            }
+        }
+        wake_goals();
+        return rclcpp_action::CancelResponse::ACCEPT;
+    }
+
+    template<typename ActionT>
+    void handle_accepted(const std::shared_ptr<rclcpp_action::ServerGoalHandle<ActionT>> goal_handle)
+    {
+        // this needs to return quickly to avoid blocking the executor, so the
+        // goal is handed to the pool
+        auto context = std::make_shared<GoalContext<ActionT>>();
+        context->handle = goal_handle;
+        context->handle_id = goal_handle.get();
+        const bool preempt = goal_policy_ == wall_follower::GoalPolicy::PREEMPT;
+        if (preempt) {
+            preempt_goals();
+            wake_goals();
+        }
+        {
+            std::lock_guard<std::mutex> lock(goals_mutex_);
+            goals_.push_back(context);
+        }
+        // the preempted goals still hold their workers until they notice, so
+        // a preempting goal queues behind them instead of counting against
+        // goal_queue (which may be 0)
+        auto job = [this, context]() {execute<ActionT>(context);};
+        const bool submitted = preempt ?
+            goal_executor_->submit_preempting(std::move(job)) : goal_executor_->submit(std::move(job));
+        if (!submitted) {
+            RCLCPP_WARN(this->get_logger(), "No free goal worker or queue slot, aborting goal");
+            forget_goal(context);
+            GoalProgress progress;
+            progress.outcome = CircleV2::Result::OUTCOME_PREEMPTED;
+            auto result = std::make_shared<typename ActionT::Result>();
+            fill_result(*result, progress);
+            goal_handle->abort(result);
+        }
+    }
+
+    void preempt_goals()
+    {
+        std::lock_guard<std::mutex> lock(goals_mutex_);
+        for (auto & context : goals_) {
+            context->preempted = true;
+        }
+    }
+
+    // Taking event_mutex_ after a flag was set means every goal thread has
+    // either seen the flag or is already waiting for this notification.
+    void wake_goals()
+    {
+        {
+            std::lock_guard<std::mutex> lock(event_mutex_);
+        }
+        goal_event_.notify_all();
+    }
+
+    void signal_goals()
+    {
+        {
+            std::lock_guard<std::mutex> lock(event_mutex_);
+            event_seq_++;
+        }
+        goal_event_.notify_all();
+    }
+
+    void forget_goal(const std::shared_ptr<GoalControl> & context)
+    {
+        {
+            std::lock_guard<std::mutex> lock(goals_mutex_);
+            goals_.erase(std::remove(goals_.begin(), goals_.end(), context), goals_.end());
+        }
+        goals_changed_.notify_all();
+    }
+
+    // Stops the robot and ends every running and queued goal; they see the
+    // preemption at once, so this returns within one goal wake-up.
+    void disarm()
+    {
+        {
+            // waits out a control step that is mid-publish; later ones see
+            // active_ false and publish nothing
+            std::lock_guard<std::mutex> lock(step_mutex_);
+            if (!active_.exchange(false)) {
+                return;
+            }
+        }
+        preempt_goals();
+        wake_goals();
+        {
+            std::unique_lock<std::mutex> lock(goals_mutex_);
+            goals_changed_.wait(lock, [this]() {return goals_.empty();});
+        }
+        publisher_->publish(stop_command_);
+        publisher_->on_deactivate();
+        stats_publisher_->on_deactivate();
+        RCLCPP_INFO(this->get_logger(), "Disarmed");
+    }
+
+    void release()
+    {
+        subscription1_.reset();
+        subscription2_.reset();
+        control_timer_.reset();
+        stats_timer_.reset();
+        action_server_.reset();
+        action_server_v2_.reset();
+        publisher_.reset();
+        stats_publisher_.reset();
+    }
+
+    template<typename ActionT>
+    void execute(const std::shared_ptr<GoalContext<ActionT>> context)
+    {
+        execute_goal(*context);
+        forget_goal(context);
+    }
+
+    static void begin_feedback(Circle::Feedback & feedback, const GoalProgress &)
+    {
+        feedback.feedback = "Starting movement...";
+    }
+
+    static void begin_feedback(CircleV2::Feedback & feedback, const GoalProgress & progress)
+    {
+        fill_feedback(feedback, progress);
+    }
+
+    static void fill_feedback(Circle::Feedback & feedback, const GoalProgress & progress)
+    {
+        feedback.feedback = progress.snapshot.touched ? "The robot touched the wall." :
+            wall_follower::to_string(progress.snapshot.state);
+    }
+
+    static void fill_feedback(CircleV2::Feedback & feedback, const GoalProgress & progress)
+    {
+        feedback.state = progress.snapshot.touched ? CircleV2::Feedback::STATE_TOUCHED_WALL :
+            static_cast<uint8_t>(progress.snapshot.state);
+        feedback.turns = progress.turns;
+        feedback.wall_distance = progress.snapshot.scan.left;
+        feedback.elapsed = static_cast<float>(progress.elapsed);
+    }
+
+    static void fill_result(Circle::Result &, const GoalProgress &)
+    {
+    }
+
+    static void fill_result(CircleV2::Result & result, const GoalProgress & progress)
+    {
+        result.outcome = progress.outcome;
+        result.circles = progress.turns / 2;
+        result.turns = progress.turns;
+        result.elapsed = static_cast<float>(progress.elapsed);
+        result.lap_min = static_cast<float>(progress.lap_min);
+        result.lap_max = static_cast<float>(progress.lap_max);
+        result.lap_mean = progress.laps > 0 ?
+            static_cast<float>(progress.lap_sum / progress.laps) : 0.0f;
+    }
+
+    // Stops the robot and ends the run, unless another goal still drives it.
+    void finish_goal_run()
+    {
+        if (goal_runs_.finish()) {
+            end_requested_ = true;
+            publisher_->publish(stop_command_);
+        }
+    }
+
+    template<typename ActionT>
+    void execute_goal(GoalContext<ActionT> & context)
+    {
+        const auto & goal_handle = context.handle;
+        RCLCPP_INFO(this->get_logger(), "Executing goal");
+        // resumes a controller that the previous goal left ENDED
+        goal_runs_.start();
+        const auto goal = goal_handle->get_goal();
+        const rclcpp::Time started = this->now();
+        GoalProgress progress;
+        progress.snapshot = snapshot_.load();
+        // circles are counted from where this goal started, not from startup
+        const uint32_t start_turns = progress.snapshot.turns;
+        double lap_started = 0.0;
+        // preallocated once; every field is rewritten before each publish
+        auto feedback = std::make_shared<typename ActionT::Feedback>();
+        auto result = std::make_shared<typename ActionT::Result>();
+        begin_feedback(*feedback, progress);
+        goal_handle->publish_feedback(feedback);
+        auto last_feedback = std::chrono::steady_clock::now();
+
+        wall_follower::ControllerSnapshot reported;
+        bool reported_any = false;
+        while (rclcpp::ok()) {
+            uint64_t seen = 0;
+            {
+                std::lock_guard<std::mutex> lock(event_mutex_);
+                seen = event_seq_;
+            }
+            progress.elapsed = (this->now() - started).seconds();
+            // Check if there is a cancel request
+            if (goal_handle->is_canceling()) {
+                progress.outcome = progress.snapshot.touched ?
+                    CircleV2::Result::OUTCOME_TOUCHED_WALL : CircleV2::Result::OUTCOME_CANCELED;
+                // the robot is stopped before the client hears the goal ended
+                finish_goal_run();
+                fill_result(*result, progress);
+                goal_handle->canceled(result);
+                return;
+            }
+            if (context.preempted || shutting_down_) {
+                RCLCPP_INFO(this->get_logger(), "Goal preempted");
+                goal_runs_.finish();
+                progress.outcome = CircleV2::Result::OUTCOME_PREEMPTED;
+                fill_result(*result, progress);
+                goal_handle->abort(result);
+                return;
+            }
+            progress.snapshot = snapshot_.load();
+            if (progress.snapshot.touched) {
+                // the robot is already stopped; report the contact and give up
+                goal_runs_.finish();
+                fill_feedback(*feedback, progress);
+                goal_handle->publish_feedback(feedback);
+                progress.outcome = CircleV2::Result::OUTCOME_TOUCHED_WALL;
+                fill_result(*result, progress);
+                goal_handle->abort(result);
+                RCLCPP_WARN(this->get_logger(), "Goal aborted: the robot touched the wall");
+                return;
+            }
+            const uint32_t turns = progress.snapshot.turns - start_turns;
+            if (turns / 2 > progress.turns / 2) {
+                const double lap = progress.elapsed - lap_started;
+                progress.lap_min = progress.laps == 0 ? lap : std::min(progress.lap_min, lap);
+                progress.lap_max = std::max(progress.lap_max, lap);
+                progress.lap_sum += lap;
+                progress.laps++;
+                lap_started = progress.elapsed;
+            }
+            progress.turns = turns;
+            if (static_cast<int64_t>(turns / 2) >= goal->circles) {
+                break;
+            }
+            // transitions inside one feedback period are coalesced into the
+            // next message, which carries the latest state
+            const auto & snapshot = progress.snapshot;
+            const bool pending = !reported_any || snapshot.state != reported.state ||
+                snapshot.turns != reported.turns;
+            const auto now = std::chrono::steady_clock::now();
+            if (pending && now >= last_feedback + feedback_period_) {
+                fill_feedback(*feedback, progress);
+                reported = snapshot;
+                reported_any = true;
+                last_feedback = now;
+                goal_handle->publish_feedback(feedback);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(event_mutex_);
+            const auto woken = [&]() {
+                return event_seq_ != seen || context.preempted || context.cancel_requested ||
+                       shutting_down_;
+            };
+            if (context.cancel_requested) {
+                // the action server marks the goal canceling right after
+                // handle_cancel returns, so this wait is short
+                goal_event_.wait_for(lock, std::chrono::microseconds(200));
+            } else if (pending) {
+                goal_event_.wait_until(lock, last_feedback + feedback_period_, woken);
+            } else {
+                goal_event_.wait(lock, woken);
+            }
+        }
+        // Check if goal is done
+        if (rclcpp::ok()) {
+            finish_goal_run();
+            fill_result(*result, progress);
+            goal_handle->succeed(result);
+            RCLCPP_INFO(this->get_logger(), "Goal succeeded");
+        } else {
+            // shutting down mid-goal: terminate it instead of leaving it executing
+            goal_runs_.finish();
+            progress.outcome = CircleV2::Result::OUTCOME_PREEMPTED;
+            fill_result(*result, progress);
+            goal_handle->abort(result);
+        }
+    }
+
+    // Priority stop path: nothing between contact and the zero command but one
+    // atomic store and a publish of a preallocated message.
+    void wall_callback(const std_msgs::msg::Bool::SharedPtr msg) {
+        if (!msg->data || !active_) {
+            return;
+        }
+        const auto received = std::chrono::steady_clock::now();
+        const bool first = !halted_.exchange(true);
+        publisher_->publish(stop_command_);
+        touch_to_stop_.record(
+            std::chrono::nanoseconds(std::chrono::steady_clock::now() - received).count());
+        if (!first) {
+            return;
+        }
+        snapshot_.update(
+            [](wall_follower::ControllerSnapshot & s) {
+                s.touched = true;
+                s.state = State::TOUCHED_WALL;
+            });
+        signal_goals();
+        RCLCPP_WARN(this->get_logger(), "The robot touched the wall, stopped");
+    }
+
+    void lidar_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg) {
+        control_step(*msg);
+    }
+
+    void mailbox_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg) {
+        scans_.post(msg);
+    }
+
+    void control_timer_callback() {
+        sensor_msgs::msg::LaserScan::SharedPtr msg;
+        if (!scans_.take(msg)) {
+            return;
+        }
+        if (scans_.dropped() != reported_drops_) {
+            reported_drops_ = scans_.dropped();
+            RCLCPP_WARN_THROTTLE(this->get_logger(), *this->get_clock(), 5000,
+                "Dropped %lu stale scans so far", reported_drops_);
+        }
+        control_step(*msg);
+    }
+
+    void publish_latency_stats() {
+        if (!active_) {
+            return;
+        }
+        diagnostic_msgs::msg::DiagnosticStatus status;
+        status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+        status.name = std::string(this->get_name()) + ": scan to cmd_vel latency";
+        for (const auto & entry : latency_.summary()) {
+            diagnostic_msgs::msg::KeyValue value;
+            value.key = entry.first;
+            value.value = entry.second;
+            status.values.push_back(value);
+        }
+        diagnostic_msgs::msg::DiagnosticArray array;
+        array.header.stamp = this->now();
+        array.status.push_back(status);
+        array.status.push_back(controller_status());
+        if (touch_to_stop_.count() > 0) {
+            array.status.back().values.push_back(
+                key_value("touch_to_stop_max_us", std::to_string(touch_to_stop_.max() / 1000.0)));
+        }
+        stats_publisher_->publish(array);
+    }
+
+    diagnostic_msgs::msg::DiagnosticStatus controller_status() const {
+        const auto snapshot = snapshot_.load();
+        diagnostic_msgs::msg::DiagnosticStatus status;
+        status.level = snapshot.touched ? diagnostic_msgs::msg::DiagnosticStatus::ERROR :
+            diagnostic_msgs::msg::DiagnosticStatus::OK;
+        status.name = std::string(this->get_name()) + ": controller";
+        status.message = wall_follower::to_string(snapshot.state);
+        const std::pair<const char *, std::string> values[] = {
+            {"turns", std::to_string(snapshot.turns)},
+            {"circles", std::to_string(snapshot.circles)},
+            {"touched", snapshot.touched ? "true" : "false"},
+            {"front_m", std::to_string(snapshot.scan.front)},
+            {"left_m", std::to_string(snapshot.scan.left)},
+            {"steps", std::to_string(snapshot.steps)},
+        };
+        for (const auto & entry : values) {
+            status.values.push_back(key_value(entry.first, entry.second));
+        }
+        return status;
+    }
+
+    // Thresholds and speeds are parameters that may change while running; each
+    // accepted change swaps in a whole validated Config.
+    void declare_config()
+    {
+        wall_follower::Config config;
+        for (const auto & f : wall_follower::config_fields()) {
+            rcl_interfaces::msg::ParameterDescriptor descriptor;
+            descriptor.description = f.description;
+            f.field(config) = this->declare_parameter(f.name, f.field(config), descriptor);
+        }
+        std::string reason;
+        if (!wall_follower::validate(config, &reason)) {
+            throw std::invalid_argument(reason);
+        }
+        config_.store(config);
+        config_callback_ = this->add_on_set_parameters_callback(
+            std::bind(&CircleWallActionServer::on_parameters, this, std::placeholders::_1));
+    }
+
+    // Parameter updates are serialised by rclcpp, so load and store here do
+    // not race another update.
+    rcl_interfaces::msg::SetParametersResult on_parameters(
+        const std::vector<rclcpp::Parameter> & parameters)
+    {
+        rcl_interfaces::msg::SetParametersResult result;
+        result.successful = true;
+        auto config = config_.load();
+        bool changed = false;
+        for (const auto & parameter : parameters) {
+            if (parameter.get_type() == rclcpp::ParameterType::PARAMETER_DOUBLE &&
+                wall_follower::set_config_field(config, parameter.get_name(), parameter.as_double()))
+            {
+                changed = true;
+            }
+        }
+        if (changed) {
+            result.successful = wall_follower::validate(config, &result.reason);
+            if (result.successful) {
+                config_.store(config);
+            }
+        }
+        return result;
+    }
+
+    static diagnostic_msgs::msg::KeyValue key_value(const std::string & key, const std::string & value) {
+        diagnostic_msgs::msg::KeyValue entry;
+        entry.key = key;
+        entry.value = value;
+        return entry;
+    }
+
+    void control_step(const sensor_msgs::msg::LaserScan & msg) {
+        std::lock_guard<std::mutex> lock(step_mutex_);
+        if (!active_) {
+            return;
+        }
+        const auto started = std::chrono::steady_clock::now();
+        latency_.receive.record((this->now() - rclcpp::Time(msg.header.stamp)).nanoseconds());
+        auto move = geometry_msgs::msg::Twist();
+        const auto scan = analyzer_.analyze(
+            msg.ranges.data(), msg.ranges.size(), msg.angle_min, msg.angle_increment,
+            msg.range_min, msg.range_max, rclcpp::Time(msg.header.stamp).seconds());
+        if (reset_requested_.exchange(false)) {
+            controller_ = wall_follower::ControllerState();
+            goal_runs_.reset();
+        }
+        const State previous_state = controller_.state;
+        const uint32_t previous_turns = controller_.turns;
+        if (end_requested_.exchange(false)) {
+            goal_runs_.end(controller_);
+        }
+        goal_runs_.resume(controller_);
+        const bool halted = halted_.load();
+        if (halted) {
+            controller_.state = State::TOUCHED_WALL;
+        }
+        // one acquire load per step; the Config is copied only after a change
+        const uint64_t config_version = config_.version();
+        if (config_version != step_config_version_) {
+            step_config_ = config_.load();
+            step_config_version_ = config_version;
+        }
+        const auto result = wall_follower::step(
+            controller_, scan, scan.stamp, step_config_, &transition_stats_);
+        const bool transition =
+            result.state.state != previous_state || result.state.turns != previous_turns;
+        controller_ = result.state;
+        snapshot_.update(
+            [&](wall_follower::ControllerSnapshot & s) {
+                s.state = controller_.state;
+                s.turns = controller_.turns;
+                s.circles = controller_.turns / 2;
+                s.scan = scan;
+                s.steps++;
+            });
+        if (transition) {
+            signal_goals();
+        }
+        move.linear.x = result.command.linear_x;
+        move.angular.z = result.command.angular_z;
+        const auto decided = std::chrono::steady_clock::now();
+        if (intra_process_) {
+            // handed over whole, so a subscriber in this process takes it without a
+            // copy; costs one allocation per step on this (non-real-time) executor
+            publisher_->publish(std::make_unique<geometry_msgs::msg::Twist>(move));
+        } else {
+            publisher_->publish(move);
+        }
+        // contact reported while this step was deciding: its stop may have
+        // gone out before the command above, so repeat it
+        if (!halted && halted_.load()) {
+            publisher_->publish(stop_command_);
+        }
+        latency_.decide.record(std::chrono::nanoseconds(decided - started).count());
+        latency_.publish.record(
+            std::chrono::nanoseconds(std::chrono::steady_clock::now() - decided).count());
+    }
+};
+
+#endif  // CIRCLE_WALL_ACTIONS_PKG__CIRCLE_WALL_SERVER_HPP_
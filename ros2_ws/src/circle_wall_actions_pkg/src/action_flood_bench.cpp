@@ -0,0 +1,142 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "circle_wall_actions_pkg/circle_wall_server.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+
+using CircleV2 = custom_interfaces::action::CircleWallV2;
+
+namespace
+{
+
+struct PhaseResult
+{
+  uint64_t scans = 0;
+  uint64_t goals = 0;
+  uint64_t p50_ns = 0;
+  uint64_t p99_ns = 0;
+  uint64_t max_ns = 0;
+};
+
+// Publishes 640-beam scans at 200 Hz to an in-process circle_wall_server
+// while flood_threads clients send goals to it and cancel them as fast as the
+// server answers, then reads the server's scan receive latency.
+PhaseResult run_phase(bool callback_groups, double seconds, int flood_threads, int64_t executor_threads)
+{
+  rclcpp::NodeOptions options;
+  options.parameter_overrides({
+    {"callback_groups", callback_groups},
+    {"executor_threads", executor_threads},
+    {"goal_policy", "reject"},
+    {"stats_period_ms", 3600000},
+  });
+  auto server = std::make_shared<CircleWallActionServer>(options);
+  rclcpp::executors::MultiThreadedExecutor server_executor(
+    rclcpp::ExecutorOptions(), server->executor_threads());
+  server_executor.add_node(server->get_node_base_interface());
+  std::thread server_thread([&server_executor]() {server_executor.spin();});
+
+  auto driver = rclcpp::Node::make_shared("action_flood_driver");
+  auto scans = driver->create_publisher<sensor_msgs::msg::LaserScan>(
+    "lidar", rclcpp::SensorDataQoS());
+  std::vector<rclcpp_action::Client<CircleV2>::SharedPtr> clients;
+  for (int i = 0; i < flood_threads; ++i) {
+    clients.push_back(rclcpp_action::create_client<CircleV2>(driver, "move_robot_v2"));
+  }
+  rclcpp::executors::MultiThreadedExecutor driver_executor;
+  driver_executor.add_node(driver);
+  std::thread driver_thread([&driver_executor]() {driver_executor.spin();});
+  for (auto & client : clients) {
+    client->wait_for_action_server(std::chrono::seconds(5));
+  }
+
+  std::atomic<bool> running{true};
+  std::atomic<uint64_t> goals{0};
+  std::vector<std::thread> flood;
+  for (auto & client : clients) {
+    flood.emplace_back(
+      [&running, &goals, client]() {
+        CircleV2::Goal goal;
+        goal.circles = 1000;
+        while (running.load(std::memory_order_relaxed)) {
+          auto handle_future = client->async_send_goal(goal);
+          goals.fetch_add(1, std::memory_order_relaxed);
+          if (handle_future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+            continue;
+          }
+          if (auto handle = handle_future.get()) {
+            client->async_cancel_goal(handle);
+          }
+        }
+      });
+  }
+
+  sensor_msgs::msg::LaserScan scan;
+  scan.angle_min = -1.396263f;
+  scan.angle_max = 1.396263f;
+  scan.angle_increment = (scan.angle_max - scan.angle_min) / 639.0f;
+  scan.range_min = 0.12f;
+  scan.range_max = 10.0f;
+  scan.ranges.assign(640, std::numeric_limits<float>::infinity());
+  const auto period = std::chrono::microseconds(5000);
+  auto next = std::chrono::steady_clock::now();
+  const auto end = next + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    next += period;
+    std::this_thread::sleep_until(next);
+    scan.header.stamp = driver->now();
+    scans->publish(scan);
+  }
+
+  running = false;
+  for (auto & t : flood) {
+    t.join();
+  }
+  PhaseResult result;
+  const auto & receive = server->latency().receive;
+  result.scans = receive.count();
+  result.goals = goals.load();
+  result.p50_ns = receive.percentile(0.5);
+  result.p99_ns = receive.percentile(0.99);
+  result.max_ns = receive.max();
+
+  driver_executor.cancel();
+  driver_thread.join();
+  server_executor.cancel();
+  server_thread.join();
+  return result;
+}
+
+}  // namespace
+
+// Scan receive latency of circle_wall_server under a flood of action goals and
+// cancels, with every callback in the node's default group and with the
+// dedicated control, safety and action groups.
+//   action_flood_bench [seconds] [flood_threads] [executor_threads]
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+  const int flood_threads = argc > 2 ? std::atoi(argv[2]) : 8;
+  const int64_t executor_threads = argc > 3 ? std::atoll(argv[3]) : 4;
+
+  std::printf(
+    "%.1f s per phase, %d flooding clients, %ld server executor threads\n",
+    seconds, flood_threads, static_cast<long>(executor_threads));
+  for (const bool groups : {false, true}) {
+    const auto r = run_phase(groups, seconds, flood_threads, executor_threads);
+    std::printf(
+      "%-14s scans=%6lu goals=%7lu  receive p50=%8.1f us  p99=%8.1f us  max=%8.1f us\n",
+      groups ? "own groups" : "default group", static_cast<unsigned long>(r.scans),
+      static_cast<unsigned long>(r.goals), r.p50_ns / 1e3, r.p99_ns / 1e3, r.max_ns / 1e3);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
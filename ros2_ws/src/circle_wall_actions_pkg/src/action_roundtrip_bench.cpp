@@ -0,0 +1,428 @@
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "custom_interfaces/action/circle_wall_v2.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_action/rclcpp_action.hpp"
+#include "rmw/rmw.h"
+#include "wall_follower_core/latency_histogram.hpp"
+
+using CircleV2 = custom_interfaces::action::CircleWallV2;
+using ServerGoalHandleV2 = rclcpp_action::ServerGoalHandle<CircleV2>;
+
+namespace
+{
+
+const char * const kLocalAction = "action_roundtrip_bench/local";
+const char * const kRemoteAction = "action_roundtrip_bench/remote";
+
+struct Stats
+{
+  uint64_t p50_ns = 0;
+  uint64_t p99_ns = 0;
+  uint64_t max_ns = 0;
+};
+
+struct PhaseResult
+{
+  const char * placement = "";
+  int clients = 0;
+  uint64_t goals = 0;
+  uint64_t rejected = 0;
+  uint64_t feedback_missing = 0;  // goals whose feedback did not arrive before the result
+  double goals_per_s = 0.0;
+  Stats accept;
+  Stats feedback;
+  Stats result;
+};
+
+int64_t steady_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Stats stats_of(const wall_follower::LatencyHistogram & h)
+{
+  return Stats{h.percentile(0.5), h.percentile(0.99), h.max()};
+}
+
+// Answers every goal at once: accepts it, then publishes one feedback and
+// succeeds, so all that is measured is the action layer. The feedback and
+// result go out from a timer rather than the accepted callback, which runs
+// right after the accept response is sent: feedback published there can
+// reach the client before it knows the goal and be dropped.
+class StubServer
+{
+public:
+  StubServer(const rclcpp::Node::SharedPtr & node, const char * name, bool best_effort_feedback)
+  {
+    auto options = rcl_action_server_get_default_options();
+    if (best_effort_feedback) {
+      options.feedback_topic_qos.reliability = RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT;
+    }
+    answer_timer_ = node->create_wall_timer(
+      std::chrono::nanoseconds(0), [this]() {answer();});
+    answer_timer_->cancel();
+    server_ = rclcpp_action::create_server<CircleV2>(
+      node, name,
+      [](const rclcpp_action::GoalUUID &, std::shared_ptr<const CircleV2::Goal>) {
+        return rclcpp_action::GoalResponse::ACCEPT_AND_EXECUTE;
+      },
+      [](const std::shared_ptr<ServerGoalHandleV2>) {
+        return rclcpp_action::CancelResponse::ACCEPT;
+      },
+      [this](const std::shared_ptr<ServerGoalHandleV2> goal_handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.push_back(goal_handle);
+        answer_timer_->reset();
+      },
+      options);
+  }
+
+private:
+  void answer()
+  {
+    std::vector<std::shared_ptr<ServerGoalHandleV2>> goals;
+    {
+      // cancel under the lock, so a goal accepted meanwhile re-arms the timer
+      std::lock_guard<std::mutex> lock(mutex_);
+      answer_timer_->cancel();
+      goals.swap(pending_);
+    }
+    for (const auto & goal_handle : goals) {
+      goal_handle->publish_feedback(std::make_shared<CircleV2::Feedback>());
+      auto result = std::make_shared<CircleV2::Result>();
+      result->outcome = CircleV2::Result::OUTCOME_COMPLETED;
+      result->circles = goal_handle->get_goal()->circles;
+      goal_handle->succeed(result);
+    }
+  }
+
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ServerGoalHandleV2>> pending_;
+  rclcpp::TimerBase::SharedPtr answer_timer_;
+  rclcpp_action::Server<CircleV2>::SharedPtr server_;
+};
+
+// Runs in the forked child for the inter-process phases until SIGTERM.
+int run_remote_server(int argc, char * argv[], bool best_effort_feedback)
+{
+  rclcpp::init(argc, argv);
+  auto node = rclcpp::Node::make_shared("action_roundtrip_stub");
+  StubServer server(node, kRemoteAction, best_effort_feedback);
+  rclcpp::spin(node);
+  rclcpp::shutdown();
+  return 0;
+}
+
+// One client with one goal in flight: the next goal is sent from the result
+// callback of the previous one, or after a rejection from a timer (the goal
+// response callback runs under a lock async_send_goal takes), so a client
+// never waits on a thread and throughput stays closed-loop.
+class ClientLoop
+{
+public:
+  ClientLoop(
+    const rclcpp::Node::SharedPtr & node, const char * name, bool best_effort_feedback,
+    PhaseResult & counts, std::atomic<bool> & running, wall_follower::LatencyHistogram & accept,
+    wall_follower::LatencyHistogram & feedback, wall_follower::LatencyHistogram & result)
+  : counts_(counts), running_(running), accept_(accept), feedback_(feedback), result_(result)
+  {
+    auto options = rcl_action_client_get_default_options();
+    if (best_effort_feedback) {
+      options.feedback_topic_qos.reliability = RMW_QOS_POLICY_RELIABILITY_BEST_EFFORT;
+    }
+    client_ = rclcpp_action::create_client<CircleV2>(node, name, nullptr, options);
+    resend_timer_ = node->create_wall_timer(
+      std::chrono::nanoseconds(0), [this]() {
+        resend_timer_->cancel();
+        if (running_.load(std::memory_order_relaxed)) {
+          send();
+        } else {
+          in_flight_ = false;
+        }
+      });
+    resend_timer_->cancel();
+  }
+
+  bool wait_for_server() {return client_->wait_for_action_server(std::chrono::seconds(10));}
+
+  void send()
+  {
+    auto options = rclcpp_action::Client<CircleV2>::SendGoalOptions();
+    options.goal_response_callback =
+      [this](const rclcpp_action::ClientGoalHandle<CircleV2>::SharedPtr & handle) {
+        accept_.record(steady_ns() - sent_ns_.load(std::memory_order_acquire));
+        if (!handle) {
+          rejected_.fetch_add(1, std::memory_order_relaxed);
+          resend_timer_->reset();
+        }
+      };
+    options.feedback_callback =
+      [this](rclcpp_action::ClientGoalHandle<CircleV2>::SharedPtr,
+        const std::shared_ptr<const CircleV2::Feedback>) {
+        if (!feedback_seen_.exchange(true, std::memory_order_relaxed)) {
+          feedback_.record(steady_ns() - sent_ns_.load(std::memory_order_acquire));
+        }
+      };
+    options.result_callback =
+      [this](const rclcpp_action::ClientGoalHandle<CircleV2>::WrappedResult &) {
+        result_.record(steady_ns() - sent_ns_.load(std::memory_order_acquire));
+        if (!feedback_seen_.load(std::memory_order_relaxed)) {
+          feedback_missing_.fetch_add(1, std::memory_order_relaxed);
+        }
+        completed_.fetch_add(1, std::memory_order_relaxed);
+        if (running_.load(std::memory_order_relaxed)) {
+          send();
+        } else {
+          in_flight_ = false;
+        }
+      };
+    CircleV2::Goal goal;
+    goal.circles = 1;
+    feedback_seen_.store(false, std::memory_order_relaxed);
+    in_flight_ = true;
+    sent_ns_.store(steady_ns(), std::memory_order_release);
+    client_->async_send_goal(goal, options);
+  }
+
+  bool in_flight() const {return in_flight_.load();}
+  uint64_t completed() const {return completed_.load(std::memory_order_relaxed);}
+
+  void add_counts() const
+  {
+    counts_.rejected += rejected_.load();
+    counts_.feedback_missing += feedback_missing_.load();
+  }
+
+private:
+  PhaseResult & counts_;
+  std::atomic<bool> & running_;
+  wall_follower::LatencyHistogram & accept_;
+  wall_follower::LatencyHistogram & feedback_;
+  wall_follower::LatencyHistogram & result_;
+  rclcpp_action::Client<CircleV2>::SharedPtr client_;
+  rclcpp::TimerBase::SharedPtr resend_timer_;
+  std::atomic<int64_t> sent_ns_{0};
+  std::atomic<bool> feedback_seen_{false};
+  std::atomic<bool> in_flight_{false};
+  std::atomic<uint64_t> completed_{0};
+  std::atomic<uint64_t> rejected_{0};
+  std::atomic<uint64_t> feedback_missing_{0};
+};
+
+// `clients` client nodes, each looping goals against the stub for `seconds`.
+// In-process the stub runs on its own executor in this process; otherwise it
+// is the forked child. Actions do not use intra-process comms, so in-process
+// still goes through the RMW, only without leaving the process.
+PhaseResult run_phase(bool in_process, int clients, double seconds, bool best_effort_feedback)
+{
+  PhaseResult r;
+  r.placement = in_process ? "in-process" : "inter-process";
+  r.clients = clients;
+  const char * name = in_process ? kLocalAction : kRemoteAction;
+
+  rclcpp::Node::SharedPtr stub_node;
+  std::unique_ptr<StubServer> stub;
+  rclcpp::executors::SingleThreadedExecutor stub_executor;
+  std::thread stub_thread;
+  if (in_process) {
+    stub_node = rclcpp::Node::make_shared("action_roundtrip_stub_local");
+    stub = std::make_unique<StubServer>(stub_node, name, best_effort_feedback);
+    stub_executor.add_node(stub_node);
+    stub_thread = std::thread([&stub_executor]() {stub_executor.spin();});
+  }
+
+  std::atomic<bool> running{true};
+  wall_follower::LatencyHistogram accept, feedback, result;
+  std::vector<rclcpp::Node::SharedPtr> nodes;
+  std::vector<std::unique_ptr<ClientLoop>> loops;
+  const int cores = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  rclcpp::executors::MultiThreadedExecutor client_executor(
+    rclcpp::ExecutorOptions(), static_cast<size_t>(std::clamp(clients, 1, cores)));
+  for (int i = 0; i < clients; ++i) {
+    nodes.push_back(rclcpp::Node::make_shared("action_roundtrip_client_" + std::to_string(i)));
+    loops.push_back(std::make_unique<ClientLoop>(
+      nodes.back(), name, best_effort_feedback, r, running, accept, feedback, result));
+    client_executor.add_node(nodes.back());
+  }
+  std::thread client_thread([&client_executor]() {client_executor.spin();});
+  const bool found = std::all_of(
+    loops.begin(), loops.end(), [](const auto & loop) {return loop->wait_for_server();});
+  if (!found) {
+    std::fprintf(stderr, "action server %s not found\n", name);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  if (found) {
+    for (auto & loop : loops) {
+      loop->send();
+    }
+    std::this_thread::sleep_until(start + std::chrono::duration<double>(seconds));
+  }
+  running = false;
+  uint64_t completed = 0;
+  for (const auto & loop : loops) {
+    completed += loop->completed();
+  }
+  const double elapsed =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  // let the goals in flight finish before the clients go away
+  const auto drain_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (std::chrono::steady_clock::now() < drain_deadline &&
+    std::any_of(loops.begin(), loops.end(), [](const auto & loop) {return loop->in_flight();}))
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  client_executor.cancel();
+  client_thread.join();
+  if (in_process) {
+    stub_executor.cancel();
+    stub_thread.join();
+  }
+
+  for (const auto & loop : loops) {
+    loop->add_counts();
+  }
+  r.goals = completed;
+  r.goals_per_s = completed / elapsed;
+  r.accept = stats_of(accept);
+  r.feedback = stats_of(feedback);
+  r.result = stats_of(result);
+  return r;
+}
+
+bool ends_with(const std::string & s, const std::string & suffix)
+{
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+void write_report(
+  const std::string & path, const std::vector<PhaseResult> & results, const char * rmw,
+  const char * qos, double seconds)
+{
+  FILE * out = std::fopen(path.c_str(), "w");
+  if (!out) {
+    std::perror(path.c_str());
+    return;
+  }
+  const bool json = ends_with(path, ".json");
+  if (json) {
+    std::fprintf(out, "[\n");
+  } else {
+    std::fprintf(
+      out, "rmw,feedback_qos,placement,clients,seconds,goals,goals_per_s,rejected,"
+      "feedback_missing,accept_p50_us,accept_p99_us,accept_max_us,feedback_p50_us,"
+      "feedback_p99_us,feedback_max_us,result_p50_us,result_p99_us,result_max_us\n");
+  }
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto & r = results[i];
+    if (json) {
+      std::fprintf(
+        out, "  {\"rmw\": \"%s\", \"feedback_qos\": \"%s\", \"placement\": \"%s\", "
+        "\"clients\": %d, \"seconds\": %.3f, \"goals\": %lu, \"goals_per_s\": %.1f, "
+        "\"rejected\": %lu, \"feedback_missing\": %lu, "
+        "\"accept_us\": {\"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f}, "
+        "\"feedback_us\": {\"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f}, "
+        "\"result_us\": {\"p50\": %.1f, \"p99\": %.1f, \"max\": %.1f}}%s\n",
+        rmw, qos, r.placement, r.clients, seconds, static_cast<unsigned long>(r.goals),
+        r.goals_per_s, static_cast<unsigned long>(r.rejected),
+        static_cast<unsigned long>(r.feedback_missing),
+        r.accept.p50_ns / 1e3, r.accept.p99_ns / 1e3, r.accept.max_ns / 1e3,
+        r.feedback.p50_ns / 1e3, r.feedback.p99_ns / 1e3, r.feedback.max_ns / 1e3,
+        r.result.p50_ns / 1e3, r.result.p99_ns / 1e3, r.result.max_ns / 1e3,
+        i + 1 < results.size() ? "," : "");
+    } else {
+      std::fprintf(
+        out, "%s,%s,%s,%d,%.3f,%lu,%.1f,%lu,%lu,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+        rmw, qos, r.placement, r.clients, seconds, static_cast<unsigned long>(r.goals),
+        r.goals_per_s, static_cast<unsigned long>(r.rejected),
+        static_cast<unsigned long>(r.feedback_missing),
+        r.accept.p50_ns / 1e3, r.accept.p99_ns / 1e3, r.accept.max_ns / 1e3,
+        r.feedback.p50_ns / 1e3, r.feedback.p99_ns / 1e3, r.feedback.max_ns / 1e3,
+        r.result.p50_ns / 1e3, r.result.p99_ns / 1e3, r.result.max_ns / 1e3);
+    }
+  }
+  if (json) {
+    std::fprintf(out, "]\n");
+  }
+  std::fclose(out);
+}
+
+}  // namespace
+
+// Action-layer overhead: goal accept, first feedback and result latency from
+// the moment a goal is sent, and closed-loop goals/s, against a stub server
+// that completes every goal at once. Each client count runs with the stub in
+// this process and in a forked child. The report (.csv, or .json) records
+// the RMW and feedback QoS so runs under different settings can be compared.
+//   action_roundtrip_bench [seconds] [report|-] [reliable|best_effort] [clients...]
+int main(int argc, char * argv[])
+{
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+  const std::string report = argc > 2 ? argv[2] : "-";
+  const std::string qos = argc > 3 ? argv[3] : "reliable";
+  const bool best_effort = qos == "best_effort";
+  std::vector<int> client_counts;
+  for (int i = 4; i < argc; ++i) {
+    client_counts.push_back(std::atoi(argv[i]));
+  }
+  if (client_counts.empty()) {
+    client_counts = {1, 4, 16};
+  }
+
+  // fork before rclcpp::init: the child must not inherit the middleware's threads
+  const pid_t stub_pid = fork();
+  if (stub_pid < 0) {
+    std::perror("fork");
+    return 1;
+  }
+  if (stub_pid == 0) {
+    std::exit(run_remote_server(argc, argv, best_effort));
+  }
+
+  rclcpp::init(argc, argv);
+  const char * rmw = rmw_get_implementation_identifier();
+  std::printf(
+    "%.1f s per phase, %s, %s feedback\n", seconds, rmw, best_effort ? "best_effort" : "reliable");
+  std::printf(
+    "%-13s %7s %9s %10s %8s %8s %21s %21s %21s\n", "placement", "clients", "goals", "goals/s",
+    "rejected", "no fb", "accept p50/p99 us", "feedback p50/p99 us", "result p50/p99 us");
+  std::vector<PhaseResult> results;
+  for (const int clients : client_counts) {
+    if (clients <= 0) {
+      continue;
+    }
+    for (const bool in_process : {true, false}) {
+      const auto r = run_phase(in_process, clients, seconds, best_effort);
+      std::printf(
+        "%-13s %7d %9lu %10.1f %8lu %8lu %10.1f/%10.1f %10.1f/%10.1f %10.1f/%10.1f\n",
+        r.placement, r.clients, static_cast<unsigned long>(r.goals), r.goals_per_s,
+        static_cast<unsigned long>(r.rejected), static_cast<unsigned long>(r.feedback_missing),
+        r.accept.p50_ns / 1e3, r.accept.p99_ns / 1e3, r.feedback.p50_ns / 1e3,
+        r.feedback.p99_ns / 1e3, r.result.p50_ns / 1e3, r.result.p99_ns / 1e3);
+      results.push_back(r);
+    }
+  }
+  if (report != "-") {
+    write_report(report, results, rmw, best_effort ? "best_effort" : "reliable", seconds);
+  }
+
+  kill(stub_pid, SIGTERM);
+  waitpid(stub_pid, nullptr, 0);
+  rclcpp::shutdown();
+  return 0;
+}
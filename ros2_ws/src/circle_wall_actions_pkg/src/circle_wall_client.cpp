@@ -1,123 +1,141 @@
-
-#include <inttypes.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
 #include <memory>
-#include <string>
-#include <iostream>
-#include <cstring>
-#include "custom_interfaces/action/circle_wall.hpp"
-#include "rclcpp/rclcpp.hpp"
-#include "rclcpp_action/rclcpp_action.hpp"
+#include "circle_wall_actions_pkg/circle_wall_client.hpp"
+
+using CircleWall = CircleWallActionClient::CircleWall;
 
-class CircleWallActionClient : public rclcpp::Node
+namespace
 {
-public:
-  using CircleWall = custom_interfaces::action::CircleWall;
-  using GoalHandleCircleWall = rclcpp_action::ClientGoalHandle<CircleWall>;
 
-  explicit CircleWallActionClient(const rclcpp::NodeOptions & node_options = rclcpp::NodeOptions())
-  : Node("circle_wall_action_client", node_options), goal_done_(false)
-  {
-    this->client_ptr_ = rclcpp_action::create_client<CircleWall>(
-      this->get_node_base_interface(),
-      this->get_node_graph_interface(),
-      this->get_node_logging_interface(),
-      this->get_node_waitables_interface(),
-      "move_robot");
-    this->timer_ = this->create_wall_timer(
-      std::chrono::milliseconds(500),
-      std::bind(&CircleWallActionClient::send_goal, this));
+void log_result(const rclcpp::Logger & logger, const CircleWallActionClient::WrappedResult & result)
+{
+  switch (result.code) {
+    case rclcpp_action::ResultCode::SUCCEEDED:
+      RCLCPP_INFO(
+        logger, "Mission Accomplished: %u circles in %.1f s, lap %.1f/%.1f/%.1f s",
+        result.result->circles, result.result->elapsed, result.result->lap_min,
+        result.result->lap_mean, result.result->lap_max);
+      return;
+    case rclcpp_action::ResultCode::ABORTED:
+      if (result.result->outcome == CircleWall::Result::OUTCOME_TOUCHED_WALL) {
+        RCLCPP_ERROR(logger, "Goal was aborted. The robot touched the wall.");
+      } else {
+        RCLCPP_ERROR(logger, "Goal was aborted");
+      }
+      return;
+    case rclcpp_action::ResultCode::CANCELED:
+      if (result.result->outcome == CircleWall::Result::OUTCOME_TOUCHED_WALL) {
+        RCLCPP_ERROR(logger, "Action canceled. The robot touched the wall.");
+      } else {
+        RCLCPP_ERROR(logger, "Action canceled");
+      }
+      return;
+    default:
+      RCLCPP_ERROR(logger, "Unknown result code");
+      return;
   }
+}
 
-  bool is_goal_done() const
-  {
-    return this->goal_done_;
+// seconds <= 0 waits forever, like spin_until_future_complete's default
+std::chrono::nanoseconds timeout_from(double seconds)
+{
+  if (seconds <= 0.0) {
+    return std::chrono::nanoseconds(-1);
   }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(seconds));
+}
 
-  void send_goal()
-  {
-    using namespace std::placeholders;
-    this->timer_->cancel();
-    this->goal_done_ = false;
-    if (!this->client_ptr_) {
-      RCLCPP_ERROR(this->get_logger(), "Action client not initialized");
-    }
-    if (!this->client_ptr_->wait_for_action_server(std::chrono::seconds(10))) {
-      RCLCPP_ERROR(this->get_logger(), "Action server not available after waiting");
-      this->goal_done_ = true;
-      return;
-    }
-    auto goal_msg = CircleWall::Goal();
-    goal_msg.circles = 2;
-    RCLCPP_INFO(this->get_logger(), "Sending goal");
-    auto send_goal_options = rclcpp_action::Client<CircleWall>::SendGoalOptions();
-                
-    send_goal_options.goal_response_callback =
-      std::bind(&CircleWallActionClient::goal_response_callback, this, _1);
-    send_goal_options.feedback_callback =
-      std::bind(&CircleWallActionClient::feedback_callback, this, _1, _2);
-    send_goal_options.result_callback =
-      std::bind(&CircleWallActionClient::result_callback, this, _1);
-      
-    auto goal_handle_future = this->client_ptr_->async_send_goal(goal_msg, send_goal_options);
-  }
+}  // namespace
 
-private:
-  rclcpp_action::Client<CircleWall>::SharedPtr client_ptr_;
-  rclcpp::TimerBase::SharedPtr timer_;
-  bool goal_done_;
-  GoalHandleCircleWall::SharedPtr goal_handle_;
+// Sends one goal and exits with its outcome: 0 when it succeeded, 1 when
+// `circles` is out of range, the server was not found, the goal was rejected,
+// failed or timed out. The main thread only spins inside
+// spin_until_future_complete, so no executor thread is ever parked in a
+// blocking call.
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  auto client = std::make_shared<CircleWallActionClient>();
+  const auto circles = client->declare_parameter<int64_t>("circles", 2);
+  const auto server_timeout = timeout_from(client->declare_parameter("server_timeout_s", 10.0));
+  const auto result_timeout = timeout_from(client->declare_parameter("result_timeout_s", 0.0));
+  const auto logger = client->get_logger();
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(client);
 
-  void goal_response_callback(const GoalHandleCircleWall::SharedPtr & goal_handle)
-  {
-    if (!goal_handle) {
-      RCLCPP_ERROR(this->get_logger(), "Goal was rejected by server");
-    } else {
-      RCLCPP_INFO(this->get_logger(), "Goal accepted by server, waiting for result");
-      this->goal_handle_ = goal_handle;
-    }
+  const auto finish = [](int code) {
+      rclcpp::shutdown();
+      return code;
+    };
+  // the goal field is a uint32; refuse rather than send a wrapped count
+  if (circles <= 0 || circles > std::numeric_limits<uint32_t>::max()) {
+    RCLCPP_ERROR(
+      logger, "circles must be in [1, %u], got %ld", std::numeric_limits<uint32_t>::max(),
+      static_cast<long>(circles));
+    return finish(1);
   }
 
-  void feedback_callback(
-    GoalHandleCircleWall::SharedPtr,
-    const std::shared_ptr<const CircleWall::Feedback> feedback)
+  auto ready = client->server_ready(server_timeout);
+  if (executor.spin_until_future_complete(ready) != rclcpp::FutureReturnCode::SUCCESS ||
+    !ready.get())
   {
-    if (!strcmp(feedback->feedback.c_str(), "The robot touched the wall."))
-      this->client_ptr_->async_cancel_all_goals();
-    RCLCPP_INFO(
-        this->get_logger(), "Feedback received: %s", feedback->feedback.c_str());
+    RCLCPP_ERROR(logger, "Action server not available after waiting");
+    return finish(1);
   }
-  
-  void result_callback(const GoalHandleCircleWall::WrappedResult & result)
+
+  CircleWall::Goal goal_msg;
+  goal_msg.circles = static_cast<uint32_t>(circles);
+  RCLCPP_INFO(logger, "Sending goal");
+  auto goal = client->send_goal(goal_msg);
+  if (executor.spin_until_future_complete(goal.accepted, std::chrono::seconds(10)) !=
+    rclcpp::FutureReturnCode::SUCCESS)
   {
-    this->goal_done_ = true;
-    switch (result.code) {
-      case rclcpp_action::ResultCode::SUCCEEDED:
-        RCLCPP_INFO(this->get_logger(), "Mission Accomplished");
-        return;
-      case rclcpp_action::ResultCode::ABORTED:
-        RCLCPP_ERROR(this->get_logger(), "Goal was aborted");
-        return;
-      case rclcpp_action::ResultCode::CANCELED:
-        RCLCPP_ERROR(this->get_logger(), "Action canceled. The robot touched the wall.");
-        return;
-      default:
-        RCLCPP_ERROR(this->get_logger(), "Unknown result code");
-        return;
-    }
-    RCLCPP_INFO(this->get_logger(), "Result received: %s", result.result->result.c_str());
+    RCLCPP_ERROR(logger, "No answer to the goal request");
+    return finish(1);
   }
-}; 
+  const auto goal_handle = goal.accepted.get();
+  if (!goal_handle) {
+    RCLCPP_ERROR(logger, "Goal was rejected by server");
+    return finish(1);
+  }
+  RCLCPP_INFO(logger, "Goal accepted by server, waiting for result");
 
-int main(int argc, char ** argv)
-{
-  rclcpp::init(argc, argv);
-  auto action_client = std::make_shared<CircleWallActionClient>();
-    
-  rclcpp::executors::MultiThreadedExecutor executor;
-  executor.add_node(action_client);
-  while (!action_client->is_goal_done()) {
-    executor.spin();
+  // the feedback stream ends when the result arrives, so waiting on it covers both
+  const auto deadline = std::chrono::steady_clock::now() + result_timeout;
+  bool canceled = false;
+  for (auto next = goal.feedback->next(); ; next = goal.feedback->next()) {
+    auto left = std::chrono::nanoseconds(-1);
+    if (result_timeout.count() >= 0) {
+      left = std::max(
+        std::chrono::nanoseconds(0),
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+          deadline - std::chrono::steady_clock::now()));
+    }
+    if (executor.spin_until_future_complete(next, left) != rclcpp::FutureReturnCode::SUCCESS) {
+      RCLCPP_ERROR(logger, "No result in time, canceling the goal");
+      executor.spin_until_future_complete(client->cancel(goal_handle), std::chrono::seconds(2));
+      executor.spin_until_future_complete(goal.result, std::chrono::seconds(2));
+      return finish(1);
+    }
+    const auto feedback = next.get();
+    if (!feedback) {
+      break;
+    }
+    RCLCPP_INFO(
+      logger, "Feedback received: state %u, %u turns, wall %.2f m, %.1f s",
+      feedback->state, feedback->turns, feedback->wall_distance, feedback->elapsed);
+    if (feedback->state == CircleWall::Feedback::STATE_TOUCHED_WALL && !canceled) {
+      // the answer arrives while spinning for the next feedback
+      client->cancel(goal_handle);
+      canceled = true;
+    }
   }
-  rclcpp::shutdown();
-  return 0;
-}
\ No newline at end of file
+
+  const auto result = goal.result.get();
+  log_result(logger, result);
+  return finish(result.code == rclcpp_action::ResultCode::SUCCEEDED ? 0 : 1);
+}
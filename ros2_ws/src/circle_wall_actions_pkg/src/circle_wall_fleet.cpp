@@ -0,0 +1,33 @@
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "circle_wall_actions_pkg/circle_wall_server.hpp"
+
+// Hosts `robots` wall-followers in one process, in namespaces robot0 ..
+// robotN-1, all spun by one MultiThreadedExecutor. Compared with one
+// circle_wall_server process per robot this shares a single DDS participant,
+// one discovery footprint and one executor. Per-robot parameters (latest_only,
+// goal_policy, ...) given on the command line apply to every robot.
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  auto host = std::make_shared<rclcpp::Node>("circle_wall_fleet");
+  const auto robots = host->declare_parameter<int64_t>("robots", 1);
+  const auto prefix = host->declare_parameter("namespace_prefix", std::string("robot"));
+  const auto threads = host->declare_parameter<int64_t>("executor_threads", 0);
+
+  rclcpp::executors::MultiThreadedExecutor executor(
+    rclcpp::ExecutorOptions(), static_cast<size_t>(std::max<int64_t>(threads, 0)));
+  executor.add_node(host);
+  std::vector<std::shared_ptr<CircleWallActionServer>> servers;
+  for (int64_t i = 0; i < robots; ++i) {
+    servers.push_back(std::make_shared<CircleWallActionServer>(prefix + std::to_string(i)));
+    executor.add_node(servers.back()->get_node_base_interface());
+  }
+  RCLCPP_INFO(host->get_logger(), "Hosting %ld robots as /%s0 .. /%s%ld",
+    static_cast<long>(robots), prefix.c_str(), prefix.c_str(), static_cast<long>(robots - 1));
+  executor.spin();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+#include "circle_wall_actions_pkg/circle_wall_co_client.hpp"
+
+using CircleWall = CircleWallCoClient::CircleWall;
+
+namespace
+{
+
+// One robot's mission as straight-line code: wait for its server, then run
+// `legs` goals of `circles` circles each, stopping at the first one that does
+// not succeed. The server aborts a goal itself when the robot touches the
+// wall, so the feedback loop only reports progress; a leg still running after
+// `leg_timeout` (0: no limit) is canceled and fails the mission.
+wall_follower::Task<bool> circle_mission(
+  CircleWallCoClient & client, rclcpp::Logger logger, int64_t legs, uint32_t circles,
+  std::chrono::nanoseconds server_timeout, std::chrono::nanoseconds leg_timeout)
+{
+  if (!co_await client.server_ready(server_timeout)) {
+    RCLCPP_ERROR(logger, "Action server not available after waiting");
+    co_return false;
+  }
+  for (int64_t leg = 1; leg <= legs; ++leg) {
+    CircleWall::Goal request;
+    request.circles = circles;
+    auto goal = co_await client.send_goal(request);
+    if (!goal) {
+      RCLCPP_ERROR(logger, "Leg %ld: goal was rejected by server", static_cast<long>(leg));
+      co_return false;
+    }
+    if (leg_timeout.count() > 0) {
+      goal->expire_after(leg_timeout);
+    }
+    uint32_t turns = 0;
+    while (auto feedback = co_await goal->next_feedback()) {
+      if (feedback->turns != turns) {
+        turns = feedback->turns;
+        RCLCPP_INFO(logger, "Leg %ld: %u turns, %.1f s", static_cast<long>(leg), turns,
+          feedback->elapsed);
+      }
+    }
+    const auto result = co_await goal->result();
+    if (goal->expired()) {
+      RCLCPP_ERROR(
+        logger, "Leg %ld timed out after %.1f s", static_cast<long>(leg),
+        std::chrono::duration<double>(leg_timeout).count());
+      co_return false;
+    }
+    if (result.code != rclcpp_action::ResultCode::SUCCEEDED) {
+      RCLCPP_ERROR(logger, "Leg %ld did not succeed", static_cast<long>(leg));
+      co_return false;
+    }
+    RCLCPP_INFO(
+      logger, "Leg %ld: %u circles in %.1f s", static_cast<long>(leg), result.result->circles,
+      result.result->elapsed);
+  }
+  co_return true;
+}
+
+}  // namespace
+
+// Runs a mission per robot, all as coroutines on one single-threaded
+// executor. With robots:=0 there is one mission against move_robot_v2;
+// otherwise one per circle_wall_fleet robot, /<namespace_prefix>N/move_robot_v2.
+// Exits with 0 when every mission succeeded.
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  auto node = std::make_shared<rclcpp::Node>("circle_wall_missions");
+  const auto robots = node->declare_parameter<int64_t>("robots", 0);
+  const auto prefix = node->declare_parameter("namespace_prefix", std::string("robot"));
+  const auto legs = node->declare_parameter<int64_t>("legs", 2);
+  const auto circles = node->declare_parameter<int64_t>("circles", 1);
+  const auto server_timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(node->declare_parameter("server_timeout_s", 10.0)));
+  const auto leg_timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::duration<double>(node->declare_parameter("leg_timeout_s", 300.0)));
+
+  // the goal field is a uint32; refuse rather than send a wrapped count
+  if (circles <= 0 || circles > std::numeric_limits<uint32_t>::max()) {
+    RCLCPP_ERROR(
+      node->get_logger(), "circles must be in [1, %u], got %ld", std::numeric_limits<uint32_t>::max(),
+      static_cast<long>(circles));
+    rclcpp::shutdown();
+    return 1;
+  }
+
+  std::vector<std::unique_ptr<CircleWallCoClient>> clients;
+  std::vector<wall_follower::Task<bool>> missions;
+  for (int64_t i = 0; i < std::max<int64_t>(robots, 1); ++i) {
+    const std::string robot = robots > 0 ? prefix + std::to_string(i) : std::string();
+    clients.push_back(std::make_unique<CircleWallCoClient>(
+      *node, robot.empty() ? "move_robot_v2" : "/" + robot + "/move_robot_v2"));
+    missions.push_back(circle_mission(
+      *clients.back(), robot.empty() ? node->get_logger() : node->get_logger().get_child(robot),
+      legs, static_cast<uint32_t>(circles), server_timeout, leg_timeout));
+  }
+
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  size_t succeeded = 0;
+  for (const auto & mission : missions) {
+    // spinning for one mission runs all of them
+    const auto status = executor.spin_until_future_complete(mission.future());
+    if (status == rclcpp::FutureReturnCode::SUCCESS && mission.future().get()) {
+      succeeded++;
+    }
+  }
+  RCLCPP_INFO(node->get_logger(), "%zu of %zu missions succeeded", succeeded, missions.size());
+  rclcpp::shutdown();
+  return succeeded == missions.size() ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+#include "circle_wall_actions_pkg/circle_wall_server.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+
+// Loadable into a component container; load it into component_container_mt so
+// its callback groups can run in parallel.
+RCLCPP_COMPONENTS_REGISTER_NODE(CircleWallActionServer)
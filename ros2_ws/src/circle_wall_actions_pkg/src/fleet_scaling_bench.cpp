@@ -0,0 +1,166 @@
+#include <sys/resource.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "circle_wall_actions_pkg/circle_wall_server.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+
+namespace
+{
+
+struct FleetResult
+{
+  uint64_t scans = 0;
+  uint64_t expected = 0;
+  double cpu_us_per_robot_s = 0.0;
+  uint64_t p50_ns = 0;  // median of the per-robot medians
+  uint64_t p99_ns = 0;  // worst per-robot p99
+  uint64_t max_ns = 0;
+};
+
+double process_cpu_seconds()
+{
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+double thread_cpu_seconds()
+{
+  timespec ts{};
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Hosts `robots` namespaced servers in this process on one executor, the way
+// circle_wall_fleet does, and feeds each /robotN/lidar with 640-beam scans at
+// scan_hz. Robots are staggered across the scan period like unsynchronised
+// lidars. CPU is the whole process minus the feeding thread, so it includes
+// the executor, the DDS threads and the idle goal pools.
+FleetResult run_fleet(int robots, double seconds, double scan_hz, int64_t executor_threads)
+{
+  rclcpp::NodeOptions options;
+  options.parameter_overrides({
+    {"stats_period_ms", 3600000},
+  });
+  std::vector<std::shared_ptr<CircleWallActionServer>> servers;
+  rclcpp::executors::MultiThreadedExecutor executor(
+    rclcpp::ExecutorOptions(), static_cast<size_t>(std::max<int64_t>(executor_threads, 0)));
+  for (int i = 0; i < robots; ++i) {
+    servers.push_back(
+      std::make_shared<CircleWallActionServer>("robot" + std::to_string(i), options));
+    executor.add_node(servers.back()->get_node_base_interface());
+  }
+  std::thread spinner([&executor]() {executor.spin();});
+
+  auto driver = rclcpp::Node::make_shared("fleet_scaling_driver");
+  std::vector<rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr> scans;
+  for (int i = 0; i < robots; ++i) {
+    scans.push_back(driver->create_publisher<sensor_msgs::msg::LaserScan>(
+      "/robot" + std::to_string(i) + "/lidar", rclcpp::SensorDataQoS()));
+  }
+  const auto discovery_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  for (auto & publisher : scans) {
+    while (publisher->get_subscription_count() == 0 &&
+      std::chrono::steady_clock::now() < discovery_deadline)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  sensor_msgs::msg::LaserScan scan;
+  scan.angle_min = -1.396263f;
+  scan.angle_max = 1.396263f;
+  scan.angle_increment = (scan.angle_max - scan.angle_min) / 639.0f;
+  scan.range_min = 0.12f;
+  scan.range_max = 10.0f;
+  scan.ranges.assign(640, std::numeric_limits<float>::infinity());
+
+  const auto slot = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(1.0 / scan_hz / robots));
+  const double cpu_before = process_cpu_seconds();
+  const double driver_before = thread_cpu_seconds();
+  auto next = std::chrono::steady_clock::now();
+  const auto end = next + std::chrono::duration<double>(seconds);
+  uint64_t published = 0;
+  while (next < end) {
+    for (auto & publisher : scans) {
+      next += slot;
+      std::this_thread::sleep_until(next);
+      scan.header.stamp = driver->now();
+      publisher->publish(scan);
+      published++;
+    }
+  }
+  // let the last scans drain before reading the clocks
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  const double driver_cpu = thread_cpu_seconds() - driver_before;
+  const double cpu = process_cpu_seconds() - cpu_before - driver_cpu;
+
+  executor.cancel();
+  spinner.join();
+
+  FleetResult result;
+  result.expected = published;
+  result.cpu_us_per_robot_s = cpu / robots / seconds * 1e6;
+  std::vector<uint64_t> medians;
+  for (const auto & server : servers) {
+    const auto & receive = server->latency().receive;
+    result.scans += receive.count();
+    medians.push_back(receive.percentile(0.5));
+    result.p99_ns = std::max(result.p99_ns, receive.percentile(0.99));
+    result.max_ns = std::max(result.max_ns, receive.max());
+  }
+  std::nth_element(medians.begin(), medians.begin() + medians.size() / 2, medians.end());
+  result.p50_ns = medians[medians.size() / 2];
+  return result;
+}
+
+}  // namespace
+
+// Per-robot cost of hosting a fleet of wall-followers in one process, for each
+// fleet size given (1, 10, 50 and 100 by default).
+//   fleet_scaling_bench [seconds] [scan_hz] [executor_threads] [robots...]
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+  const double scan_hz = argc > 2 ? std::atof(argv[2]) : 10.0;
+  const int64_t executor_threads = argc > 3 ? std::atoll(argv[3]) : 0;
+  std::vector<int> fleets;
+  for (int i = 4; i < argc; ++i) {
+    fleets.push_back(std::atoi(argv[i]));
+  }
+  if (fleets.empty()) {
+    fleets = {1, 10, 50, 100};
+  }
+
+  std::printf(
+    "%.1f s per fleet, %.1f Hz scans per robot, %ld executor threads (0 = one per core)\n",
+    seconds, scan_hz, static_cast<long>(executor_threads));
+  std::printf(
+    "%7s %10s %10s %16s %12s %12s %12s\n", "robots", "scans", "lost", "cpu us/robot/s",
+    "p50 us", "worst p99 us", "max us");
+  for (const int robots : fleets) {
+    if (robots <= 0) {
+      continue;
+    }
+    const auto r = run_fleet(robots, seconds, scan_hz, executor_threads);
+    std::printf(
+      "%7d %10lu %10lu %16.1f %12.1f %12.1f %12.1f\n", robots,
+      static_cast<unsigned long>(r.scans),
+      static_cast<unsigned long>(r.expected > r.scans ? r.expected - r.scans : 0),
+      r.cpu_us_per_robot_s, r.p50_ns / 1e3, r.p99_ns / 1e3, r.max_ns / 1e3);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include <sys/resource.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <thread>
+#include "circle_wall_actions_pkg/circle_wall_server.hpp"
+#include "geometry_msgs/msg/twist.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "wall_follower_core/latency_histogram.hpp"
+
+namespace
+{
+
+struct PhaseResult
+{
+  uint64_t scans = 0;
+  uint64_t commands = 0;
+  uint64_t receive_p50_ns = 0;
+  uint64_t receive_p99_ns = 0;
+  uint64_t round_trip_p50_ns = 0;
+  uint64_t round_trip_p99_ns = 0;
+  uint64_t round_trip_max_ns = 0;
+  double cpu_percent = 0.0;
+};
+
+double process_cpu_seconds()
+{
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+int64_t steady_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A driver node and circle_wall_server in one process, the layout of a
+// component container: the driver publishes 640-beam scans on lidar as
+// unique_ptr and times each cmd_vel against the scan it answers. Both nodes
+// share one use_intra_process_comms setting, so the two phases differ only
+// in whether messages cross the middleware.
+PhaseResult run_phase(bool intra_process, double seconds, double scan_hz)
+{
+  rclcpp::NodeOptions options;
+  options.use_intra_process_comms(intra_process);
+  options.parameter_overrides({
+    {"stats_period_ms", 3600000},
+  });
+  auto server = std::make_shared<CircleWallActionServer>(options);
+  rclcpp::executors::MultiThreadedExecutor server_executor(
+    rclcpp::ExecutorOptions(), server->executor_threads());
+  server_executor.add_node(server->get_node_base_interface());
+  std::thread server_thread([&server_executor]() {server_executor.spin();});
+
+  wall_follower::LatencyHistogram round_trip;
+  std::atomic<int64_t> last_scan_ns{0};
+  auto driver = rclcpp::Node::make_shared(
+    "intra_process_driver", rclcpp::NodeOptions().use_intra_process_comms(intra_process));
+  auto scans = driver->create_publisher<sensor_msgs::msg::LaserScan>(
+    "lidar", rclcpp::SensorDataQoS());
+  auto commands = driver->create_subscription<geometry_msgs::msg::Twist>(
+    "cmd_vel", 10,
+    [&round_trip, &last_scan_ns](geometry_msgs::msg::Twist::UniquePtr) {
+      round_trip.record(steady_ns() - last_scan_ns.load(std::memory_order_acquire));
+    });
+  rclcpp::executors::SingleThreadedExecutor driver_executor;
+  driver_executor.add_node(driver);
+  std::thread driver_thread([&driver_executor]() {driver_executor.spin();});
+  const auto discovery_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while ((scans->get_subscription_count() == 0 || commands->get_publisher_count() == 0) &&
+    std::chrono::steady_clock::now() < discovery_deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  sensor_msgs::msg::LaserScan scan;
+  scan.angle_min = -1.396263f;
+  scan.angle_max = 1.396263f;
+  scan.angle_increment = (scan.angle_max - scan.angle_min) / 639.0f;
+  scan.range_min = 0.12f;
+  scan.range_max = 10.0f;
+  scan.ranges.assign(640, std::numeric_limits<float>::infinity());
+
+  const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+    std::chrono::duration<double>(1.0 / scan_hz));
+  const double cpu_before = process_cpu_seconds();
+  auto next = std::chrono::steady_clock::now();
+  const auto end = next + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    next += period;
+    std::this_thread::sleep_until(next);
+    auto message = std::make_unique<sensor_msgs::msg::LaserScan>(scan);
+    message->header.stamp = driver->now();
+    last_scan_ns.store(steady_ns(), std::memory_order_release);
+    scans->publish(std::move(message));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  const double cpu = process_cpu_seconds() - cpu_before;
+
+  driver_executor.cancel();
+  driver_thread.join();
+  server_executor.cancel();
+  server_thread.join();
+
+  PhaseResult result;
+  const auto & receive = server->latency().receive;
+  result.scans = receive.count();
+  result.commands = round_trip.count();
+  result.receive_p50_ns = receive.percentile(0.5);
+  result.receive_p99_ns = receive.percentile(0.99);
+  result.round_trip_p50_ns = round_trip.percentile(0.5);
+  result.round_trip_p99_ns = round_trip.percentile(0.99);
+  result.round_trip_max_ns = round_trip.max();
+  result.cpu_percent = cpu / seconds * 100.0;
+  return result;
+}
+
+}  // namespace
+
+// lidar -> circle_wall_server -> cmd_vel through the middleware and with
+// intra-process zero-copy, as in separate processes versus one container.
+//   intra_process_bench [seconds] [scan_hz]
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 10.0;
+  const double scan_hz = argc > 2 ? std::atof(argv[2]) : 100.0;
+
+  std::printf("%.1f s per phase, %.1f Hz scans\n", seconds, scan_hz);
+  for (const bool intra_process : {false, true}) {
+    const auto r = run_phase(intra_process, seconds, scan_hz);
+    std::printf(
+      "%-13s scans=%6lu cmds=%6lu  receive p50=%7.1f us p99=%7.1f us  "
+      "scan->cmd_vel p50=%7.1f us p99=%7.1f us max=%7.1f us  cpu=%5.1f%%\n",
+      intra_process ? "intra-process" : "middleware", static_cast<unsigned long>(r.scans),
+      static_cast<unsigned long>(r.commands), r.receive_p50_ns / 1e3, r.receive_p99_ns / 1e3,
+      r.round_trip_p50_ns / 1e3, r.round_trip_p99_ns / 1e3, r.round_trip_max_ns / 1e3,
+      r.cpu_percent);
+  }
+  rclcpp::shutdown();
+  return 0;
+}
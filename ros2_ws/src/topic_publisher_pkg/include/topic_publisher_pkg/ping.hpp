@@ -0,0 +1,48 @@
+#ifndef TOPIC_PUBLISHER_PKG__PING_HPP_
+#define TOPIC_PUBLISHER_PKG__PING_HPP_
+
+#include <sys/resource.h>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "rclcpp/rclcpp.hpp"
+
+// Shared by the ping side (SimplePublisher) and the echo side
+// (SimpleSubscriber) of the ping/pong benchmark.
+namespace ping_pong
+{
+
+// reliability is "reliable" or "best_effort"; both sides must agree.
+inline rclcpp::QoS qos(const std::string & reliability, int64_t depth)
+{
+  if (depth < 1 || (reliability != "reliable" && reliability != "best_effort")) {
+    throw std::invalid_argument("depth must be >= 1 and reliability reliable or best_effort");
+  }
+  rclcpp::QoS qos(static_cast<size_t>(depth));
+  if (reliability == "best_effort") {
+    qos.best_effort();
+  } else {
+    qos.reliable();
+  }
+  return qos;
+}
+
+// CLOCK_MONOTONIC, which every process on the host shares
+inline int64_t steady_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline double process_cpu_seconds()
+{
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+         (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+}  // namespace ping_pong
+
+#endif  // TOPIC_PUBLISHER_PKG__PING_HPP_
@@ -0,0 +1,161 @@
+#ifndef TOPIC_PUBLISHER_PKG__SIMPLE_PUBLISHER_HPP_
+#define TOPIC_PUBLISHER_PKG__SIMPLE_PUBLISHER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "custom_interfaces/msg/ping.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "std_msgs/msg/int32.hpp"
+#include "topic_publisher_pkg/ping.hpp"
+#include "wall_follower_core/latency_histogram.hpp"
+
+// Counts on `counter` every 500 ms. With ping:=true it is instead the sending
+// side of a ping/pong benchmark: Ping messages of payload_bytes go out on
+// `ping` at rate_hz once an echo (SimpleSubscriber with echo:=true) is
+// matched, and the echoes coming back on `pong` are timed.
+class SimplePublisher : public rclcpp::Node
+{
+public:
+  using Ping = custom_interfaces::msg::Ping;
+
+  struct PingStats
+  {
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> payload_bytes{0};  // received back
+    wall_follower::LatencyHistogram one_way;  // ping -> echo
+    wall_follower::LatencyHistogram round_trip;
+  };
+
+  explicit SimplePublisher(const rclcpp::NodeOptions & options = rclcpp::NodeOptions())
+  : Node("simple_publisher", options), count_(0)
+  {
+    if (this->declare_parameter("ping", false)) {
+      start_ping();
+      return;
+    }
+    publisher_ = this->create_publisher<std_msgs::msg::Int32>("counter", 10);
+    timer_ = rclcpp::create_timer(
+      this, this->get_clock(), std::chrono::milliseconds(500),
+      std::bind(&SimplePublisher::timer_callback, this));
+  }
+
+  const PingStats & ping_stats() const {return stats_;}
+
+  bool ping_matched() const
+  {
+    return ping_publisher_ && ping_publisher_->get_subscription_count() > 0 &&
+           pong_subscription_->get_publisher_count() > 0;
+  }
+
+  // No more pings; echoes still in flight are still counted.
+  void stop_ping()
+  {
+    if (timer_) {
+      timer_->cancel();
+    }
+  }
+
+private:
+  void timer_callback()
+  {
+    auto message = std::make_unique<std_msgs::msg::Int32>();
+    message->data = count_;
+    count_++;
+    publisher_->publish(std::move(message));
+  }
+
+  void start_ping()
+  {
+    const auto rate_hz = this->declare_parameter("rate_hz", 100.0);
+    payload_bytes_ = this->declare_parameter<int64_t>("payload_bytes", 4);
+    const auto reliability = this->declare_parameter("reliability", std::string("reliable"));
+    const auto depth = this->declare_parameter<int64_t>("depth", 10);
+    const auto report_period_ms = this->declare_parameter<int64_t>("report_period_ms", 1000);
+    if (rate_hz <= 0.0 || payload_bytes_ < 0) {
+      throw std::invalid_argument("rate_hz must be positive and payload_bytes >= 0");
+    }
+    const auto qos = ping_pong::qos(reliability, depth);
+    ping_publisher_ = this->create_publisher<Ping>("ping", qos);
+    pong_subscription_ = this->create_subscription<Ping>(
+      "pong", qos, std::bind(&SimplePublisher::pong_callback, this, std::placeholders::_1));
+    const auto period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::duration<double>(1.0 / rate_hz));
+    timer_ = rclcpp::create_timer(
+      this, this->get_clock(), period, std::bind(&SimplePublisher::ping_callback, this));
+    if (report_period_ms > 0) {
+      report_timer_ = rclcpp::create_timer(
+        this, this->get_clock(), std::chrono::milliseconds(report_period_ms),
+        std::bind(&SimplePublisher::report, this));
+    }
+  }
+
+  void ping_callback()
+  {
+    if (!started_) {
+      // pings sent before the echo is matched would only count as lost
+      if (!ping_matched()) {
+        return;
+      }
+      started_ = true;
+      start_ns_ = ping_pong::steady_ns();
+      start_cpu_ = ping_pong::process_cpu_seconds();
+    }
+    auto message = std::make_unique<Ping>();
+    message->seq = count_++;
+    message->payload.resize(static_cast<size_t>(payload_bytes_));
+    message->sent_ns = ping_pong::steady_ns();
+    ping_publisher_->publish(std::move(message));
+    stats_.sent.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void pong_callback(Ping::UniquePtr message)
+  {
+    const int64_t now = ping_pong::steady_ns();
+    stats_.round_trip.record(now - message->sent_ns);
+    stats_.one_way.record(message->echoed_ns - message->sent_ns);
+    stats_.payload_bytes.fetch_add(message->payload.size(), std::memory_order_relaxed);
+    stats_.received.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Totals since the first ping; pings still in flight count as lost.
+  void report()
+  {
+    if (!started_) {
+      RCLCPP_INFO(this->get_logger(), "Waiting for an echo on pong");
+      return;
+    }
+    const double seconds = (ping_pong::steady_ns() - start_ns_) / 1e9;
+    const uint64_t sent = stats_.sent.load(std::memory_order_relaxed);
+    const uint64_t received = stats_.received.load(std::memory_order_relaxed);
+    RCLCPP_INFO(
+      this->get_logger(),
+      "%lu sent, %lu lost, %.1f msg/s, %.2f MB/s, one-way p50/p99 %.1f/%.1f us, "
+      "round trip p50/p99 %.1f/%.1f us, cpu %.1f%%",
+      static_cast<unsigned long>(sent),
+      static_cast<unsigned long>(sent > received ? sent - received : 0), received / seconds,
+      stats_.payload_bytes.load(std::memory_order_relaxed) / seconds / 1e6,
+      stats_.one_way.percentile(0.5) / 1e3, stats_.one_way.percentile(0.99) / 1e3,
+      stats_.round_trip.percentile(0.5) / 1e3, stats_.round_trip.percentile(0.99) / 1e3,
+      (ping_pong::process_cpu_seconds() - start_cpu_) / seconds * 100.0);
+  }
+
+  rclcpp::TimerBase::SharedPtr timer_;
+  rclcpp::Publisher<std_msgs::msg::Int32>::SharedPtr publisher_;
+  size_t count_;
+
+  rclcpp::Publisher<Ping>::SharedPtr ping_publisher_;
+  rclcpp::Subscription<Ping>::SharedPtr pong_subscription_;
+  rclcpp::TimerBase::SharedPtr report_timer_;
+  int64_t payload_bytes_ = 0;
+  bool started_ = false;
+  int64_t start_ns_ = 0;
+  double start_cpu_ = 0.0;
+  PingStats stats_;
+};
+
+#endif  // TOPIC_PUBLISHER_PKG__SIMPLE_PUBLISHER_HPP_
@@ -0,0 +1,98 @@
+#ifndef TOPIC_PUBLISHER_PKG__SIMPLE_SUBSCRIBER_HPP_
+#define TOPIC_PUBLISHER_PKG__SIMPLE_SUBSCRIBER_HPP_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include "custom_interfaces/msg/ping.hpp"
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "std_msgs/msg/int32.hpp"
+#include "topic_publisher_pkg/ping.hpp"
+#include "wall_follower_core/sequence_stats.hpp"
+
+// Link-health probe for `counter`: the counter is a sequence, so every
+// message updates gap, reorder, duplicate and inter-arrival statistics, which
+// go out on `diagnostics` every stats_period_ms (WARN when messages were lost,
+// duplicated or the counter restarted since the previous report). With
+// echo:=true it also answers every Ping on `ping` by stamping it and sending
+// the same message back on `pong`; with intra-process comms the message goes
+// out and back without a copy.
+class SimpleSubscriber : public rclcpp::Node
+{
+public:
+  using Ping = custom_interfaces::msg::Ping;
+
+  explicit SimpleSubscriber(const rclcpp::NodeOptions & options = rclcpp::NodeOptions())
+  : Node("simple_subscriber", options)
+  {
+    subscription_ = this->create_subscription<std_msgs::msg::Int32>(
+      "counter", 10, std::bind(&SimpleSubscriber::topic_callback, this, std::placeholders::_1));
+    // a number further back than this behind the highest seen is a restart
+    stats_ = wall_follower::SequenceStats(
+      this->declare_parameter<int64_t>("reorder_tolerance", 16));
+    const auto stats_period_ms = this->declare_parameter<int64_t>("stats_period_ms", 1000);
+    if (stats_period_ms > 0) {
+      stats_publisher_ =
+        this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("diagnostics", 10);
+      stats_timer_ = rclcpp::create_timer(
+        this, this->get_clock(), std::chrono::milliseconds(stats_period_ms),
+        std::bind(&SimpleSubscriber::publish_stats, this));
+    }
+    if (this->declare_parameter("echo", false)) {
+      const auto qos = ping_pong::qos(
+        this->declare_parameter("reliability", std::string("reliable")),
+        this->declare_parameter<int64_t>("depth", 10));
+      pong_publisher_ = this->create_publisher<Ping>("pong", qos);
+      ping_subscription_ = this->create_subscription<Ping>(
+        "ping", qos, std::bind(&SimpleSubscriber::ping_callback, this, std::placeholders::_1));
+    }
+  }
+
+private:
+  void topic_callback(const std_msgs::msg::Int32::SharedPtr msg)
+  {
+    stats_.record(msg->data, ping_pong::steady_ns());
+    RCLCPP_DEBUG(this->get_logger(), "I heard: '%d'", msg->data);
+  }
+
+  void publish_stats()
+  {
+    diagnostic_msgs::msg::DiagnosticStatus status;
+    status.name = std::string(this->get_name()) + ": counter link";
+    const uint64_t faults = stats_.lost() + stats_.duplicates() + stats_.restarts();
+    status.level = faults > reported_faults_ ?
+      diagnostic_msgs::msg::DiagnosticStatus::WARN : diagnostic_msgs::msg::DiagnosticStatus::OK;
+    reported_faults_ = faults;
+    std::string line;
+    for (const auto & entry : stats_.summary(ping_pong::steady_ns())) {
+      diagnostic_msgs::msg::KeyValue value;
+      value.key = entry.first;
+      value.value = entry.second;
+      status.values.push_back(value);
+      line += (line.empty() ? "" : " ") + entry.first + "=" + entry.second;
+    }
+    RCLCPP_INFO(this->get_logger(), "%s", line.c_str());
+    diagnostic_msgs::msg::DiagnosticArray array;
+    array.header.stamp = this->now();
+    array.status.push_back(status);
+    stats_publisher_->publish(array);
+  }
+
+  void ping_callback(Ping::UniquePtr msg)
+  {
+    msg->echoed_ns = ping_pong::steady_ns();
+    pong_publisher_->publish(std::move(msg));
+  }
+
+  rclcpp::Subscription<std_msgs::msg::Int32>::SharedPtr subscription_;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr stats_publisher_;
+  rclcpp::TimerBase::SharedPtr stats_timer_;
+  wall_follower::SequenceStats stats_;
+  uint64_t reported_faults_ = 0;  // lost + duplicates + restarts
+  rclcpp::Subscription<Ping>::SharedPtr ping_subscription_;
+  rclcpp::Publisher<Ping>::SharedPtr pong_publisher_;
+};
+
+#endif  // TOPIC_PUBLISHER_PKG__SIMPLE_SUBSCRIBER_HPP_
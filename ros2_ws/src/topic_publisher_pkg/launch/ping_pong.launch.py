@@ -0,0 +1,34 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+from launch_ros.parameter_descriptions import ParameterValue
+
+def generate_launch_description():
+    # ping and echo as separate processes; ping_pong_bench also covers
+    # intra-process and sweeps payload sizes
+    qos = {
+        'reliability': LaunchConfiguration('reliability'),
+        'depth': ParameterValue(LaunchConfiguration('depth'), value_type=int),
+    }
+    return LaunchDescription([
+        DeclareLaunchArgument('rate_hz', default_value='100.0'),
+        DeclareLaunchArgument('payload_bytes', default_value='4'),
+        DeclareLaunchArgument('reliability', default_value='reliable'),
+        DeclareLaunchArgument('depth', default_value='10'),
+        Node(
+            package='topic_publisher_pkg',
+            executable='simple_subscriber',
+            parameters=[{'echo': True, 'stats_period_ms': 0}, qos],
+            output='screen'),
+        Node(
+            package='topic_publisher_pkg',
+            executable='simple_publisher',
+            parameters=[{
+                'ping': True,
+                'rate_hz': ParameterValue(LaunchConfiguration('rate_hz'), value_type=float),
+                'payload_bytes':
+                    ParameterValue(LaunchConfiguration('payload_bytes'), value_type=int),
+            }, qos],
+            output='screen'),
+    ])
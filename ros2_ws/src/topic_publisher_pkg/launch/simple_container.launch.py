@@ -0,0 +1,26 @@
+from launch import LaunchDescription
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+def generate_launch_description():
+    # publisher and subscriber in one process; counter messages are handed
+    # over as pointers instead of going through the middleware
+    intra_process = [{'use_intra_process_comms': True}]
+    return LaunchDescription([
+        ComposableNodeContainer(
+            name='simple_container',
+            namespace='',
+            package='rclcpp_components',
+            executable='component_container',
+            composable_node_descriptions=[
+                ComposableNode(
+                    package='topic_publisher_pkg',
+                    plugin='SimplePublisher',
+                    extra_arguments=intra_process),
+                ComposableNode(
+                    package='topic_publisher_pkg',
+                    plugin='SimpleSubscriber',
+                    extra_arguments=intra_process),
+            ],
+            output='screen'),
+    ])
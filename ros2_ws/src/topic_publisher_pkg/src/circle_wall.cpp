@@ -1,84 +1,349 @@
+#include "diagnostic_msgs/msg/diagnostic_array.hpp"
 #include "geometry_msgs/msg/twist.hpp"
+#include "lifecycle_msgs/msg/state.hpp"
 #include "rclcpp/publisher.hpp"
 #include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+#include "rclcpp_lifecycle/lifecycle_node.hpp"
 #include "sensor_msgs/msg/laser_scan.hpp"
 #include "std_msgs/msg/int32.hpp"
+#include "wall_follower_core/config_fields.hpp"
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/latency_histogram.hpp"
+#include "wall_follower_core/latest_mailbox.hpp"
+#include "wall_follower_core/realtime.hpp"
+#include "wall_follower_core/seqlock.hpp"
+#include "wall_follower_core/spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <iostream>
+#include <stdexcept>
 #include <array>
 
 using std::placeholders::_1;
 using namespace std;
 
-enum state {
-    APPROACH = 0,
-    TURN_RIGHT = 1,
-    MOVE_ALONG = 2,
-    TURN_LEFT_WALL = 3
-};
+// Lifecycle node: configure creates the publishers, subscriptions, timers and
+// control thread, activate arms the controller from APPROACH and deactivate
+// stops the robot and ignores scans until the next activation.
+class CircleWall : public rclcpp_lifecycle::LifecycleNode {
+public:
+  using CallbackReturn = rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn;
 
-int currentState = APPROACH;
-const int SCAN_SIZE = 640;
+  explicit CircleWall(const rclcpp::NodeOptions & options = rclcpp::NodeOptions())
+  : LifecycleNode("circle_wall_node", options) {
+    // latest_only: scans go through a single-slot mailbox and a control timer
+    // always steps on the freshest one, dropping any that went stale meanwhile
+    latest_only_ = this->declare_parameter("latest_only", false);
+    control_period_ = std::chrono::milliseconds(
+        this->declare_parameter<int64_t>("control_period_ms", 10));
+    // rt_thread: the control step runs on its own thread fed through a wait-free
+    // queue, pinned to rt_cpu, at SCHED_FIFO rt_priority and with memory locked
+    rt_thread_ = this->declare_parameter("rt_thread", false);
+    rt_options_.cpu = this->declare_parameter<int>("rt_cpu", -1);
+    rt_options_.priority = this->declare_parameter<int>("rt_priority", 0);
+    rt_options_.lock_memory = this->declare_parameter("rt_lock_memory", true);
+    stats_period_ = std::chrono::milliseconds(
+        this->declare_parameter<int64_t>("stats_period_ms", 1000));
+    declare_config();
+    // autostart: configure and activate right away, as a plain node would
+    // run; false leaves the node unconfigured for a lifecycle manager
+    if (this->declare_parameter("autostart", true)) {
+      if (this->configure().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_INACTIVE ||
+          this->activate().id() != lifecycle_msgs::msg::State::PRIMARY_STATE_ACTIVE) {
+        throw std::runtime_error("circle_wall failed to autostart");
+      }
+    }
+  }
 
-class CircleWall : public rclcpp::Node {
-public:
-  CircleWall() : Node("circle_wall_node") {
-    subscription_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
-        "lidar", 10, std::bind(&CircleWall::topic_callback, this, _1));
+  ~CircleWall() {
+    stop_control_thread();
+    const uint64_t dropped = scans_.dropped() + rt_dropped_.load();
+    if (dropped > 0) {
+      RCLCPP_INFO(this->get_logger(), "Dropped %lu stale scans", dropped);
+    }
+    RCLCPP_INFO(this->get_logger(), "Scan latency: %s", latency_.to_string().c_str());
+  }
+
+  CallbackReturn on_configure(const rclcpp_lifecycle::State &) override {
+    rclcpp::PublisherOptions cmd_vel_options;
+    if (rt_thread_) {
+      // an intra-process publish allocates a message per call; the real-time
+      // thread sends its preallocated one through the middleware instead
+      cmd_vel_options.use_intra_process_comm = rclcpp::IntraProcessSetting::Disable;
+    }
     publisher_ = 
-        this->create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 10);
+        this->create_publisher<geometry_msgs::msg::Twist>("cmd_vel", 10, cmd_vel_options);
+    stats_publisher_ =
+        this->create_publisher<diagnostic_msgs::msg::DiagnosticArray>("diagnostics", 10);
+    stats_timer_ = rclcpp::create_timer(
+        this, this->get_clock(), stats_period_, std::bind(&CircleWall::publish_latency_stats, this));
+    if (rt_thread_) {
+      subscription_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
+          "lidar", rclcpp::SensorDataQoS(), std::bind(&CircleWall::rt_queue_callback, this, _1));
+      rt_running_ = true;
+      control_thread_ = std::thread(&CircleWall::control_thread_loop, this, rt_options_);
+    } else if (latest_only_) {
+      subscription_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
+          "lidar", rclcpp::SensorDataQoS(), std::bind(&CircleWall::mailbox_callback, this, _1));
+      // wall time: under sim time a lockstep clock only advances once a scan
+      // is answered, so a sim-clock timer would wait on itself
+      control_timer_ = this->create_wall_timer(
+          control_period_, std::bind(&CircleWall::control_timer_callback, this));
+    } else {
+      subscription_ = this->create_subscription<sensor_msgs::msg::LaserScan>(
+          "lidar", rclcpp::SensorDataQoS(), std::bind(&CircleWall::topic_callback, this, _1));
+    }
+    return CallbackReturn::SUCCESS;
+  }
+
+  // re-arm: the next scan starts a fresh run from APPROACH
+  CallbackReturn on_activate(const rclcpp_lifecycle::State &) override {
+    reset_requested_ = true;
+    publisher_->on_activate();
+    stats_publisher_->on_activate();
+    active_ = true;
+    return CallbackReturn::SUCCESS;
+  }
+
+  CallbackReturn on_deactivate(const rclcpp_lifecycle::State &) override {
+    disarm();
+    return CallbackReturn::SUCCESS;
+  }
+
+  CallbackReturn on_cleanup(const rclcpp_lifecycle::State &) override {
+    release();
+    return CallbackReturn::SUCCESS;
+  }
+
+  CallbackReturn on_shutdown(const rclcpp_lifecycle::State &) override {
+    disarm();
+    release();
+    return CallbackReturn::SUCCESS;
   }
 
 private:
+  // Thresholds and speeds are parameters that may change while running; each
+  // accepted change swaps in a whole validated Config.
+  void declare_config() {
+    wall_follower::Config config;
+    for (const auto & f : wall_follower::config_fields()) {
+      rcl_interfaces::msg::ParameterDescriptor descriptor;
+      descriptor.description = f.description;
+      f.field(config) = this->declare_parameter(f.name, f.field(config), descriptor);
+    }
+    std::string reason;
+    if (!wall_follower::validate(config, &reason)) {
+      throw std::invalid_argument(reason);
+    }
+    config_.store(config);
+    config_callback_ = this->add_on_set_parameters_callback(
+        std::bind(&CircleWall::on_parameters, this, _1));
+  }
+
+  // Parameter updates are serialised by rclcpp, so load and store here do
+  // not race another update.
+  rcl_interfaces::msg::SetParametersResult on_parameters(
+      const std::vector<rclcpp::Parameter> & parameters) {
+    rcl_interfaces::msg::SetParametersResult result;
+    result.successful = true;
+    auto config = config_.load();
+    bool changed = false;
+    for (const auto & parameter : parameters) {
+      if (parameter.get_type() == rclcpp::ParameterType::PARAMETER_DOUBLE &&
+          wall_follower::set_config_field(config, parameter.get_name(), parameter.as_double())) {
+        changed = true;
+      }
+    }
+    if (changed) {
+      result.successful = wall_follower::validate(config, &result.reason);
+      if (result.successful) {
+        config_.store(config);
+      }
+    }
+    return result;
+  }
+
+  void disarm() {
+    {
+      // waits out a control step that is mid-publish; later ones see active_
+      // false and publish nothing
+      std::lock_guard<wall_follower::PiMutex> lock(step_mutex_);
+      if (!active_.exchange(false)) {
+        return;
+      }
+    }
+    publisher_->publish(geometry_msgs::msg::Twist());
+    publisher_->on_deactivate();
+    stats_publisher_->on_deactivate();
+  }
+
+  void stop_control_thread() {
+    if (control_thread_.joinable()) {
+      rt_running_ = false;
+      rt_wakeup_.post();
+      control_thread_.join();
+    }
+  }
+
+  void release() {
+    subscription_.reset();
+    stop_control_thread();
+    control_timer_.reset();
+    stats_timer_.reset();
+    publisher_.reset();
+    stats_publisher_.reset();
+  }
+
   void topic_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg) {
-      auto message = geometry_msgs::msg::Twist();
-      switch (currentState){
-        case APPROACH:
-            message.linear.x = 1;
-            if(msg->ranges[320] < 1.0){
-                message.linear.x = 0.0;
-                currentState = TURN_RIGHT;
-            }
-            break;
-        case TURN_RIGHT:
-            message.angular.z = -0.3;
-            if(msg->ranges[320] > 10.0 && msg->ranges[639] > 2.0){
-                message.angular.z = 0.0;
-                message.linear.x = 0.0;
-                currentState = MOVE_ALONG;
-            }
-            break;
-        case MOVE_ALONG:
-            message.linear.x = 1.5;
-            if(msg->ranges[639] > 10.0){
-                for (u_int i = 0; i < 0xFFFFFFFF; i++);
-                message.linear.x = 0.0;
-                currentState = TURN_LEFT_WALL;
-            }
-            if(msg->ranges[639] < 2.0){
-                message.linear.x = 0.0;
-                currentState = TURN_RIGHT;
-            }
-            break;
-        case TURN_LEFT_WALL:
-            message.angular.z = 0.3;
-            message.linear.x = 0.75;
-            if(msg->ranges[639] < 2.1 && msg->ranges[320] > 10.0){
-                message.angular.z = 0.0;
-                message.linear.x = 0.0;
-                currentState = MOVE_ALONG;
-            }
-            break;
+      control_step(*msg);
+  }
+
+  void mailbox_callback(const sensor_msgs::msg::LaserScan::SharedPtr msg) {
+      scans_.post(msg);
+  }
+
+  void control_timer_callback() {
+      sensor_msgs::msg::LaserScan::SharedPtr msg;
+      if (!scans_.take(msg)) {
+          return;
+      }
+      if (scans_.dropped() != reported_drops_) {
+          reported_drops_ = scans_.dropped();
+          RCLCPP_WARN_THROTTLE(this->get_logger(), *this->get_clock(), 5000,
+              "Dropped %lu stale scans so far", reported_drops_);
+      }
+      control_step(*msg);
+  }
+
+  void rt_queue_callback(sensor_msgs::msg::LaserScan::SharedPtr msg) {
+      if (rt_queue_.push(std::move(msg))) {
+          rt_wakeup_.post();
+      } else {
+          rt_dropped_++;
+      }
+  }
+
+  void control_thread_loop(wall_follower::RealtimeOptions options) {
+      std::string error;
+      if (!wall_follower::configure_current_thread(options, &error)) {
+          RCLCPP_WARN(this->get_logger(), "Control thread is not fully realtime: %s", error.c_str());
+      }
+      sensor_msgs::msg::LaserScan::SharedPtr msg;
+      sensor_msgs::msg::LaserScan::SharedPtr next;
+      while (rt_running_.load()) {
+          if (!rt_wakeup_.wait_for(100000000L)) {
+              continue;
+          }
+          // only the freshest queued scan is worth acting on
+          while (rt_queue_.pop(next)) {
+              if (msg) {
+                  rt_dropped_++;
+              }
+              msg = std::move(next);
+          }
+          if (msg) {
+              control_step(*msg);
+              msg.reset();
+          }
+      }
+  }
+
+  void publish_latency_stats() {
+      if (!active_) {
+          return;
+      }
+      diagnostic_msgs::msg::DiagnosticStatus status;
+      status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+      status.name = std::string(this->get_name()) + ": scan to cmd_vel latency";
+      for (const auto & entry : latency_.summary()) {
+          diagnostic_msgs::msg::KeyValue value;
+          value.key = entry.first;
+          value.value = entry.second;
+          status.values.push_back(value);
+      }
+      diagnostic_msgs::msg::DiagnosticArray array;
+      array.header.stamp = this->now();
+      array.status.push_back(status);
+      stats_publisher_->publish(array);
+  }
+
+  void control_step(const sensor_msgs::msg::LaserScan & msg) {
+      std::lock_guard<wall_follower::PiMutex> lock(step_mutex_);
+      if (!active_) {
+          return;
+      }
+      if (reset_requested_.exchange(false)) {
+          controller_ = wall_follower::ControllerState();
+      }
+      const auto started = std::chrono::steady_clock::now();
+      latency_.receive.record((this->now() - rclcpp::Time(msg.header.stamp)).nanoseconds());
+      auto & message = cmd_vel_;
+      const auto scan = analyzer_.analyze(
+          msg.ranges.data(), msg.ranges.size(), msg.angle_min, msg.angle_increment,
+          msg.range_min, msg.range_max, rclcpp::Time(msg.header.stamp).seconds());
+      // one acquire load per step; the Config is copied only after a change
+      const uint64_t config_version = config_.version();
+      if (config_version != step_config_version_) {
+          step_config_ = config_.load();
+          step_config_version_ = config_version;
+      }
+      const auto result = wall_follower::step(
+          controller_, scan, scan.stamp, step_config_, &transition_stats_);
+      controller_ = result.state;
+      message.linear.x = result.command.linear_x;
+      message.angular.z = result.command.angular_z;
+      const auto decided = std::chrono::steady_clock::now();
+      if (intra_process_ && !rt_thread_) {
+        // handed over whole, so a subscriber in this process takes it without a copy
+        publisher_->publish(std::make_unique<geometry_msgs::msg::Twist>(message));
+      } else {
+        // nothing to hand over across processes; keep the step allocation-free
+        publisher_->publish(message);
       }
-      publisher_->publish(message);
+      latency_.decide.record(std::chrono::nanoseconds(decided - started).count());
+      latency_.publish.record(
+          std::chrono::nanoseconds(std::chrono::steady_clock::now() - decided).count());
   }
     
+  wall_follower::ScanAnalyzer analyzer_;
+  wall_follower::Seqlock<wall_follower::Config> config_;
+  // the control step's copy of config_, refreshed when its version moves
+  wall_follower::Config step_config_;
+  uint64_t step_config_version_ = 0;
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr config_callback_;
+  wall_follower::ControllerState controller_;
+  wall_follower::TransitionStats transition_stats_;
+  wall_follower::LatestMailbox<sensor_msgs::msg::LaserScan::SharedPtr> scans_;
+  uint64_t reported_drops_ = 0;
+  rclcpp::TimerBase::SharedPtr control_timer_;
+  geometry_msgs::msg::Twist cmd_vel_;
+  const bool intra_process_ = this->get_node_options().use_intra_process_comms();
+  wall_follower::LatencyStages latency_;
+  rclcpp::TimerBase::SharedPtr stats_timer_;
+  rclcpp_lifecycle::LifecyclePublisher<diagnostic_msgs::msg::DiagnosticArray>::SharedPtr stats_publisher_;
+  wall_follower::SpscQueue<sensor_msgs::msg::LaserScan::SharedPtr, 16> rt_queue_;
+  wall_follower::Wakeup rt_wakeup_;
+  std::atomic<bool> rt_running_{false};
+  std::atomic<uint64_t> rt_dropped_{0};
+  std::thread control_thread_;
   rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr subscription_;
-  rclcpp::Publisher<geometry_msgs::msg::Twist>::SharedPtr publisher_;
+  rclcpp_lifecycle::LifecyclePublisher<geometry_msgs::msg::Twist>::SharedPtr publisher_;
+  bool latest_only_ = false;
+  std::chrono::milliseconds control_period_{10};
+  std::chrono::milliseconds stats_period_{1000};
+  bool rt_thread_ = false;
+  wall_follower::RealtimeOptions rt_options_;
+  // set while the lifecycle state is active; the control step does nothing otherwise
+  std::atomic<bool> active_{false};
+  // held by a control step from its active_ check to its publish, so disarm
+  // sends the last command before the publisher is deactivated; inherits the
+  // priority of a real-time control thread waiting on it
+  wall_follower::PiMutex step_mutex_;
+  std::atomic<bool> reset_requested_{false};
 };
 
-int main(int argc, char *argv[]) {
-  rclcpp::init(argc, argv);
-  rclcpp::spin(std::make_shared<CircleWall>());
-  rclcpp::shutdown();
-  return 0;
-}
\ No newline at end of file
+RCLCPP_COMPONENTS_REGISTER_NODE(CircleWall)
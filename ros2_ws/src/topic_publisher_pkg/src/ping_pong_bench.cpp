@@ -0,0 +1,241 @@
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rclcpp/rclcpp.hpp"
+#include "rmw/rmw.h"
+#include "topic_publisher_pkg/simple_publisher.hpp"
+#include "topic_publisher_pkg/simple_subscriber.hpp"
+
+namespace
+{
+
+struct Settings
+{
+  double seconds = 5.0;
+  double rate_hz = 100.0;
+  std::string reliability = "reliable";
+  int64_t depth = 10;
+};
+
+struct PhaseResult
+{
+  const char * placement = "";
+  int64_t payload_bytes = 0;
+  uint64_t sent = 0;
+  uint64_t received = 0;
+  double msgs_per_s = 0.0;
+  double mb_per_s = 0.0;
+  uint64_t one_way_p50_ns = 0;
+  uint64_t one_way_p99_ns = 0;
+  uint64_t round_trip_p50_ns = 0;
+  uint64_t round_trip_p99_ns = 0;
+  uint64_t round_trip_max_ns = 0;
+  double cpu_percent = 0.0;  // ping and echo side together
+};
+
+// utime + stime of another process, from /proc/<pid>/stat
+double pid_cpu_seconds(pid_t pid)
+{
+  std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+  std::string line;
+  std::getline(stat, line);
+  const auto comm_end = line.rfind(')');
+  if (comm_end == std::string::npos) {
+    return 0.0;
+  }
+  std::istringstream fields(line.substr(comm_end + 2));
+  std::string field;
+  unsigned long long utime = 0, stime = 0;
+  // fields 3 (state) to 13 come first
+  for (int i = 3; i <= 15 && fields >> field; ++i) {
+    if (i == 14) {
+      utime = std::stoull(field);
+    } else if (i == 15) {
+      stime = std::stoull(field);
+    }
+  }
+  return static_cast<double>(utime + stime) / static_cast<double>(sysconf(_SC_CLK_TCK));
+}
+
+rclcpp::NodeOptions node_options(
+  const Settings & s, const std::string & ns, bool intra_process,
+  std::vector<rclcpp::Parameter> parameters)
+{
+  parameters.emplace_back("reliability", s.reliability);
+  parameters.emplace_back("depth", s.depth);
+  return rclcpp::NodeOptions()
+         .use_intra_process_comms(intra_process)
+         .arguments({"--ros-args", "-r", "__ns:=" + ns})
+         .parameter_overrides(parameters);
+}
+
+// Runs in the forked child for the inter-process phases until SIGTERM.
+int run_remote_echo(int argc, char * argv[], const Settings & s)
+{
+  rclcpp::init(argc, argv);
+  auto echo = std::make_shared<SimpleSubscriber>(
+    node_options(s, "/ping_pong_inter", false, {{"echo", true}, {"stats_period_ms", 0}}));
+  rclcpp::spin(echo);
+  rclcpp::shutdown();
+  return 0;
+}
+
+// One payload size at rate_hz. Intra-process both sides run in this process
+// with use_intra_process_comms, each on its own executor thread; otherwise
+// the echo is the forked child.
+PhaseResult run_phase(bool intra_process, int64_t payload_bytes, const Settings & s, pid_t echo_pid)
+{
+  PhaseResult r;
+  r.placement = intra_process ? "intra-process" : "inter-process";
+  r.payload_bytes = payload_bytes;
+  const std::string ns = intra_process ? "/ping_pong_intra" : "/ping_pong_inter";
+
+  std::shared_ptr<SimpleSubscriber> echo;
+  rclcpp::executors::SingleThreadedExecutor echo_executor;
+  std::thread echo_thread;
+  if (intra_process) {
+    echo = std::make_shared<SimpleSubscriber>(
+      node_options(s, ns, true, {{"echo", true}, {"stats_period_ms", 0}}));
+    echo_executor.add_node(echo);
+    echo_thread = std::thread([&echo_executor]() {echo_executor.spin();});
+  }
+  auto ping = std::make_shared<SimplePublisher>(
+    node_options(
+      s, ns, intra_process, {
+        {"ping", true}, {"rate_hz", s.rate_hz}, {"payload_bytes", payload_bytes},
+        {"report_period_ms", 0}}));
+  rclcpp::executors::SingleThreadedExecutor ping_executor;
+  ping_executor.add_node(ping);
+  std::thread ping_thread([&ping_executor]() {ping_executor.spin();});
+
+  const auto discovery_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!ping->ping_matched() && std::chrono::steady_clock::now() < discovery_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  const auto cpu_now = [intra_process, echo_pid]() {
+      return ping_pong::process_cpu_seconds() + (intra_process ? 0.0 : pid_cpu_seconds(echo_pid));
+    };
+  const double cpu_before = cpu_now();
+  std::this_thread::sleep_for(std::chrono::duration<double>(s.seconds));
+  ping->stop_ping();
+  const double cpu = cpu_now() - cpu_before;
+  const auto & stats = ping->ping_stats();
+  // echoes still in flight after the last ping are not lost
+  const auto drain_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (stats.received.load() < stats.sent.load() &&
+    std::chrono::steady_clock::now() < drain_deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  ping_executor.cancel();
+  ping_thread.join();
+  if (intra_process) {
+    echo_executor.cancel();
+    echo_thread.join();
+  }
+
+  r.sent = stats.sent.load();
+  r.received = stats.received.load();
+  r.msgs_per_s = r.received / s.seconds;
+  r.mb_per_s = stats.payload_bytes.load() / s.seconds / 1e6;
+  r.one_way_p50_ns = stats.one_way.percentile(0.5);
+  r.one_way_p99_ns = stats.one_way.percentile(0.99);
+  r.round_trip_p50_ns = stats.round_trip.percentile(0.5);
+  r.round_trip_p99_ns = stats.round_trip.percentile(0.99);
+  r.round_trip_max_ns = stats.round_trip.max();
+  r.cpu_percent = cpu / s.seconds * 100.0;
+  return r;
+}
+
+}  // namespace
+
+// SimplePublisher (ping) against SimpleSubscriber (echo) for each payload
+// size, intra-process and across processes: one-way and round-trip latency,
+// throughput, loss and the CPU of both sides. 4 bytes is the size of the
+// counter's Int32. The optional CSV report can be appended across runs with
+// different RMW_IMPLEMENTATION or QoS.
+//   ping_pong_bench [seconds] [rate_hz] [reliable|best_effort] [depth] [report.csv|-]
+//                   [payload_bytes...]
+int main(int argc, char * argv[])
+{
+  Settings s;
+  s.seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+  s.rate_hz = argc > 2 ? std::atof(argv[2]) : 100.0;
+  s.reliability = argc > 3 ? argv[3] : "reliable";
+  s.depth = argc > 4 ? std::atoll(argv[4]) : 10;
+  const std::string report = argc > 5 ? argv[5] : "-";
+  std::vector<int64_t> payloads;
+  for (int i = 6; i < argc; ++i) {
+    payloads.push_back(std::atoll(argv[i]));
+  }
+  if (payloads.empty()) {
+    payloads = {4, 1024, 65536, 1048576, 4194304};
+  }
+
+  // fork before rclcpp::init: the child must not inherit the middleware's threads
+  const pid_t echo_pid = fork();
+  if (echo_pid < 0) {
+    std::perror("fork");
+    return 1;
+  }
+  if (echo_pid == 0) {
+    std::exit(run_remote_echo(argc, argv, s));
+  }
+
+  rclcpp::init(argc, argv);
+  const bool new_report = report != "-" && std::ifstream(report, std::ios::ate).tellg() <= 0;
+  FILE * csv = report != "-" ? std::fopen(report.c_str(), "a") : nullptr;
+  if (csv && new_report) {
+    std::fprintf(
+      csv, "rmw,reliability,depth,rate_hz,placement,payload_bytes,sent,received,msgs_per_s,"
+      "mb_per_s,one_way_p50_us,one_way_p99_us,round_trip_p50_us,round_trip_p99_us,"
+      "round_trip_max_us,cpu_percent\n");
+  }
+  const char * rmw = rmw_get_implementation_identifier();
+  std::printf(
+    "%.1f s per phase at %.1f Hz, %s, %s depth %ld\n", s.seconds, s.rate_hz, rmw,
+    s.reliability.c_str(), static_cast<long>(s.depth));
+  std::printf(
+    "%-13s %10s %8s %7s %9s %9s %19s %19s %9s %6s\n", "placement", "bytes", "sent", "lost",
+    "msg/s", "MB/s", "one-way p50/p99 us", "rtt p50/p99 us", "rtt max", "cpu%");
+  for (const int64_t payload : payloads) {
+    for (const bool intra_process : {true, false}) {
+      const auto r = run_phase(intra_process, payload, s, echo_pid);
+      const uint64_t lost = r.sent > r.received ? r.sent - r.received : 0;
+      std::printf(
+        "%-13s %10ld %8lu %7lu %9.1f %9.2f %9.1f/%9.1f %9.1f/%9.1f %9.1f %6.1f\n", r.placement,
+        static_cast<long>(r.payload_bytes), static_cast<unsigned long>(r.sent),
+        static_cast<unsigned long>(lost), r.msgs_per_s, r.mb_per_s, r.one_way_p50_ns / 1e3,
+        r.one_way_p99_ns / 1e3, r.round_trip_p50_ns / 1e3, r.round_trip_p99_ns / 1e3,
+        r.round_trip_max_ns / 1e3, r.cpu_percent);
+      if (csv) {
+        std::fprintf(
+          csv, "%s,%s,%ld,%.1f,%s,%ld,%lu,%lu,%.1f,%.3f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n", rmw,
+          s.reliability.c_str(), static_cast<long>(s.depth), s.rate_hz, r.placement,
+          static_cast<long>(r.payload_bytes), static_cast<unsigned long>(r.sent),
+          static_cast<unsigned long>(r.received), r.msgs_per_s, r.mb_per_s,
+          r.one_way_p50_ns / 1e3, r.one_way_p99_ns / 1e3, r.round_trip_p50_ns / 1e3,
+          r.round_trip_p99_ns / 1e3, r.round_trip_max_ns / 1e3, r.cpu_percent);
+      }
+    }
+  }
+  if (csv) {
+    std::fclose(csv);
+  }
+
+  kill(echo_pid, SIGTERM);
+  waitpid(echo_pid, nullptr, 0);
+  rclcpp::shutdown();
+  return 0;
+}
@@ -1,30 +1,4 @@
-#include "rclcpp/rclcpp.hpp"
-#include "std_msgs/msg/int32.hpp"
+#include "topic_publisher_pkg/simple_subscriber.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
 
-using std::placeholders::_1;
-
-class SimpleSubscriber : public rclcpp::Node
-{
-public:
-  SimpleSubscriber()
-  : Node("simple_subscriber")
-  {
-   subscription_ = this->create_subscription<std_msgs::msg::Int32>(
-     "counter", 10, std::bind(&SimpleSubscriber::topic_callback, this, _1));
-  }
-
-private:
-  void topic_callback(const std_msgs::msg::Int32::SharedPtr msg)
-  {
-   RCLCPP_INFO(this->get_logger(), "I heard: '%d'", msg->data);
-  }
-  rclcpp::Subscription<std_msgs::msg::Int32>::SharedPtr subscription_;
-};
-
-int main(int argc, char * argv [])
-{
-  rclcpp::init(argc, argv);
-  rclcpp::spin(std::make_shared<SimpleSubscriber>());
-  rclcpp::shutdown();
-  return 0;
-}
+RCLCPP_COMPONENTS_REGISTER_NODE(SimpleSubscriber)
@@ -1,6 +1,7 @@
 
 #include "rclcpp/rclcpp.hpp"
 #include "std_msgs/msg/int32.hpp"
+#include <chrono>
 
 int main(int argc, char * argv[])
 {
@@ -9,14 +10,18 @@ int main(int argc, char * argv[])
   auto publisher = node->create_publisher<std_msgs::msg::Int32>("counter", 10);
   auto message = std::make_shared<std_msgs::msg::Int32>();
   message->data = 0;
-  rclcpp::WallRate loop_rate(2);
+  // paced on the node clock so it follows /clock under use_sim_time
+  auto clock = node->get_clock();
+  const rclcpp::Duration period(std::chrono::milliseconds(500));
+  rclcpp::Time next = clock->now() + period;
 
   while (rclcpp::ok()) {
     
     publisher->publish(*message);
     message->data++;
     rclcpp::spin_some(node);
-    loop_rate.sleep();
+    clock->sleep_until(next);
+    next += period;
   }
   rclcpp::shutdown();
   return 0;
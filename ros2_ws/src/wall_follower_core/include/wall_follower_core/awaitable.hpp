@@ -0,0 +1,206 @@
+#ifndef WALL_FOLLOWER_CORE__AWAITABLE_HPP_
+#define WALL_FOLLOWER_CORE__AWAITABLE_HPP_
+
+#if __cplusplus < 202002L
+#error "wall_follower_core/awaitable.hpp needs C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace wall_follower
+{
+
+// Coroutine building blocks for callback-driven code. A coroutine that
+// co_awaits one of these suspends without holding a thread and is resumed
+// inline by whoever completes it, normally a ROS callback, so it continues on
+// the executor thread that ran that callback. One coroutine may wait on each
+// object at a time.
+
+// A value set once; awaiting it returns a copy.
+template<typename T>
+class AwaitableValue
+{
+public:
+  struct Awaiter
+  {
+    AwaitableValue * self;
+
+    bool await_ready() const {return self->ready();}
+
+    bool await_suspend(std::coroutine_handle<> waiter)
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      if (self->value_) {
+        return false;
+      }
+      self->waiter_ = waiter;
+      return true;
+    }
+
+    T await_resume()
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      return *self->value_;
+    }
+  };
+
+  // Later calls are ignored.
+  void set(T value)
+  {
+    std::coroutine_handle<> waiter;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (value_) {
+        return;
+      }
+      value_.emplace(std::move(value));
+      waiter = std::exchange(waiter_, nullptr);
+    }
+    if (waiter) {
+      waiter.resume();
+    }
+  }
+
+  bool ready() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return value_.has_value();
+  }
+
+  Awaiter operator co_await() {return Awaiter{this};}
+
+private:
+  mutable std::mutex mutex_;
+  std::optional<T> value_;
+  std::coroutine_handle<> waiter_;
+};
+
+// A stream of values. Awaiting next() returns the oldest value not taken yet;
+// after close() and once the buffer is drained it returns the default T
+// (nullptr for a shared_ptr). At most `capacity` values are buffered; past
+// that the oldest is dropped.
+template<typename T>
+class AwaitableQueue
+{
+public:
+  struct Awaiter
+  {
+    AwaitableQueue * self;
+
+    bool await_ready() const {return false;}
+
+    bool await_suspend(std::coroutine_handle<> waiter)
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      if (!self->ready_.empty() || self->closed_) {
+        return false;
+      }
+      self->waiter_ = waiter;
+      return true;
+    }
+
+    T await_resume()
+    {
+      std::lock_guard<std::mutex> lock(self->mutex_);
+      if (self->ready_.empty()) {
+        return T();
+      }
+      T value = std::move(self->ready_.front());
+      self->ready_.pop_front();
+      return value;
+    }
+  };
+
+  explicit AwaitableQueue(std::size_t capacity = 64)
+  : capacity_(capacity ? capacity : 1) {}
+
+  // Ignored once closed.
+  void push(T value)
+  {
+    std::coroutine_handle<> waiter;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) {
+        return;
+      }
+      if (ready_.size() == capacity_) {
+        ready_.pop_front();
+        dropped_++;
+      }
+      ready_.push_back(std::move(value));
+      waiter = std::exchange(waiter_, nullptr);
+    }
+    if (waiter) {
+      waiter.resume();
+    }
+  }
+
+  void close()
+  {
+    std::coroutine_handle<> waiter;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      waiter = std::exchange(waiter_, nullptr);
+    }
+    if (waiter) {
+      waiter.resume();
+    }
+  }
+
+  Awaiter next() {return Awaiter{this};}
+
+  std::uint64_t dropped() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+private:
+  const std::size_t capacity_;
+  mutable std::mutex mutex_;
+  std::deque<T> ready_;
+  bool closed_ = false;
+  std::uint64_t dropped_ = 0;
+  std::coroutine_handle<> waiter_;
+};
+
+// Return type of a detached coroutine. It starts running when called and
+// frees its frame when it finishes; the outcome (value or exception) is
+// published on future(), e.g. for spin_until_future_complete. A coroutine
+// suspended on something that never completes is never freed.
+template<typename T>
+class Task
+{
+public:
+  struct promise_type
+  {
+    std::promise<T> outcome;
+
+    Task get_return_object() {return Task(outcome.get_future().share());}
+    std::suspend_never initial_suspend() noexcept {return {};}
+    std::suspend_never final_suspend() noexcept {return {};}
+    void return_value(T value) {outcome.set_value(std::move(value));}
+    void unhandled_exception() {outcome.set_exception(std::current_exception());}
+  };
+
+  const std::shared_future<T> & future() const {return future_;}
+
+private:
+  explicit Task(std::shared_future<T> future)
+  : future_(std::move(future)) {}
+
+  std::shared_future<T> future_;
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__AWAITABLE_HPP_
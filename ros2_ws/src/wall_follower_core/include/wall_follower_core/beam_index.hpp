@@ -0,0 +1,104 @@
+#ifndef WALL_FOLLOWER_CORE__BEAM_INDEX_HPP_
+#define WALL_FOLLOWER_CORE__BEAM_INDEX_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "wall_follower_core/scan_sectors.hpp"
+
+namespace wall_follower
+{
+
+// Angular sector in the sensor frame, in radians, counter-clockwise positive.
+struct SectorAngles
+{
+  float from;
+  float to;
+};
+
+// Angle -> beam index lookup table built from LaserScan metadata. The table
+// covers [-pi, pi] in fixed bins and is only rebuilt when the metadata changes,
+// so lookups on the hot path are a clamp and a load for any sensor.
+class BeamIndex
+{
+public:
+  // bins per radian; the default resolves a quarter of a degree
+  explicit BeamIndex(float resolution = 229.2f)
+  : resolution_(resolution)
+  {}
+
+  // Returns true when the table had to be (re)built for this metadata.
+  bool update(float angle_min, float angle_increment, std::size_t size)
+  {
+    if (built_ && angle_min == angle_min_ && angle_increment == angle_increment_ &&
+      size == size_)
+    {
+      return false;
+    }
+    built_ = true;
+    angle_min_ = angle_min;
+    angle_increment_ = angle_increment;
+    size_ = size;
+    table_.clear();
+    if (size == 0 || angle_increment == 0.0f) {
+      return true;
+    }
+    const std::size_t bins = static_cast<std::size_t>(std::ceil(2.0f * kPi * resolution_)) + 1;
+    table_.resize(bins);
+    for (std::size_t bin = 0; bin < bins; ++bin) {
+      const float angle = -kPi + static_cast<float>(bin) / resolution_;
+      const float beam = std::round((angle - angle_min) / angle_increment);
+      const float last = static_cast<float>(size - 1);
+      table_[bin] = static_cast<std::uint32_t>(beam < 0.0f ? 0.0f : (beam > last ? last : beam));
+    }
+    return true;
+  }
+
+  // Nearest beam to angle, clamped to the scan's field of view.
+  std::size_t index(float angle) const
+  {
+    if (table_.empty()) {
+      return 0;
+    }
+    float bin = std::round((angle + kPi) * resolution_);
+    const float last = static_cast<float>(table_.size() - 1);
+    bin = bin < 0.0f ? 0.0f : (bin > last ? last : bin);
+    return table_[static_cast<std::size_t>(bin)];
+  }
+
+  // Beams covering [angles.from, angles.to], whichever way the sensor sweeps.
+  SectorSpan span(const SectorAngles & angles) const
+  {
+    if (table_.empty()) {
+      return SectorSpan{0, 0};
+    }
+    std::size_t begin = index(angles.from);
+    std::size_t end = index(angles.to);
+    if (begin > end) {
+      std::size_t tmp = begin;
+      begin = end;
+      end = tmp;
+    }
+    return SectorSpan{begin, end + 1};
+  }
+
+  std::size_t size() const
+  {
+    return size_;
+  }
+
+private:
+  static constexpr float kPi = 3.14159265358979f;
+
+  float resolution_;
+  bool built_ = false;
+  float angle_min_ = 0.0f;
+  float angle_increment_ = 0.0f;
+  std::size_t size_ = 0;
+  std::vector<std::uint32_t> table_;
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__BEAM_INDEX_HPP_
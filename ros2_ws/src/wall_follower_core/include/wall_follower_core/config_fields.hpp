@@ -0,0 +1,96 @@
+#ifndef WALL_FOLLOWER_CORE__CONFIG_FIELDS_HPP_
+#define WALL_FOLLOWER_CORE__CONFIG_FIELDS_HPP_
+
+#include <array>
+#include <cmath>
+#include <string>
+#include "wall_follower_core/controller.hpp"
+
+namespace wall_follower
+{
+
+// One tunable Config value, exposed by the nodes as a double parameter of the
+// same name.
+struct ConfigField
+{
+  const char * name;
+  const char * description;
+  double & (*field)(Config &);
+};
+
+inline const std::array<ConfigField, 10> & config_fields()
+{
+  static const std::array<ConfigField, 10> fields = {{
+    {"approach_distance", "front distance (m) at which the approach turns onto the wall",
+      [](Config & c) -> double & {return c.approach_distance;}},
+    {"open_distance", "range (m) beyond which a sector counts as open",
+      [](Config & c) -> double & {return c.open_distance;}},
+    {"wall_lost_distance", "left distance (m) below which the robot turns away from the wall",
+      [](Config & c) -> double & {return c.wall_lost_distance;}},
+    {"wall_found_distance", "left distance (m) below which a turn ends on the wall",
+      [](Config & c) -> double & {return c.wall_found_distance;}},
+    {"approach_speed", "forward speed (m/s) while approaching",
+      [](Config & c) -> double & {return c.approach_speed;}},
+    {"move_speed", "forward speed (m/s) along the wall",
+      [](Config & c) -> double & {return c.move_speed;}},
+    {"turn_speed", "forward speed (m/s) while turning around the wall",
+      [](Config & c) -> double & {return c.turn_speed;}},
+    {"yaw_rate", "turn rate (rad/s)",
+      [](Config & c) -> double & {return c.yaw_rate;}},
+    {"corner_hold_s",
+      "seconds to keep driving past the end of the wall, 0 to hold by distance only "
+      "(with corner_hold_m also 0 the turn starts at once)",
+      [](Config & c) -> double & {return c.corner_hold.seconds;}},
+    {"corner_hold_m",
+      "metres to keep driving past the end of the wall, 0 to hold by time only "
+      "(with corner_hold_s also 0 the turn starts at once)",
+      [](Config & c) -> double & {return c.corner_hold.metres;}},
+  }};
+  return fields;
+}
+
+// Sets the field called name; false when no field has that name.
+inline bool set_config_field(Config & config, const std::string & name, double value)
+{
+  for (const auto & f : config_fields()) {
+    if (name == f.name) {
+      f.field(config) = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// False, with the reason, for a config the controller cannot run on.
+inline bool validate(const Config & c, std::string * reason)
+{
+  const auto fail = [reason](const char * why) {
+      if (reason) {
+        *reason = why;
+      }
+      return false;
+    };
+  Config copy = c;
+  for (const auto & f : config_fields()) {
+    const double value = f.field(copy);
+    if (!std::isfinite(value) || value < 0.0) {
+      return fail("values must be finite and non-negative");
+    }
+  }
+  if (c.approach_distance <= 0.0 || c.yaw_rate <= 0.0 || c.approach_speed <= 0.0 ||
+    c.move_speed <= 0.0)
+  {
+    return fail("approach_distance, yaw_rate, approach_speed and move_speed must be positive");
+  }
+  if (c.wall_lost_distance >= c.wall_found_distance) {
+    return fail("wall_lost_distance must be below wall_found_distance");
+  }
+  if (c.approach_distance >= c.open_distance || c.wall_found_distance >= c.open_distance) {
+    return fail("approach_distance and wall_found_distance must be below open_distance");
+  }
+  return true;
+}
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__CONFIG_FIELDS_HPP_
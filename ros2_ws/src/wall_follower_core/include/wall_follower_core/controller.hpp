@@ -0,0 +1,316 @@
+#ifndef WALL_FOLLOWER_CORE__CONTROLLER_HPP_
+#define WALL_FOLLOWER_CORE__CONTROLLER_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include "wall_follower_core/scan_analyzer.hpp"
+#include "wall_follower_core/transition_hold.hpp"
+
+namespace wall_follower
+{
+
+enum class State : std::uint8_t
+{
+  APPROACH = 0,
+  TURN_RIGHT = 1,
+  MOVE_ALONG = 2,
+  TURN_LEFT_WALL = 3,
+  ENDED = 4,
+  TOUCHED_WALL = 5
+};
+
+constexpr std::size_t kStateCount = 6;
+
+inline const char * to_string(State state)
+{
+  switch (state) {
+    case State::APPROACH:
+      return "Approaching";
+    case State::TURN_RIGHT:
+      return "Turning right";
+    case State::MOVE_ALONG:
+      return "Moving";
+    case State::TURN_LEFT_WALL:
+      return "Turning";
+    case State::ENDED:
+      return "Ended";
+    case State::TOUCHED_WALL:
+      return "The robot touched the wall.";
+  }
+  return "Unknown";
+}
+
+// The two Twist fields the controller drives.
+struct Command
+{
+  double linear_x = 0.0;
+  double angular_z = 0.0;
+};
+
+// Distances in metres, speeds in m/s and rad/s.
+struct Config
+{
+  double approach_distance = 1.0;
+  double open_distance = 10.0;
+  double wall_lost_distance = 2.0;
+  double wall_found_distance = 2.1;
+  double approach_speed = 1.0;
+  double move_speed = 1.5;
+  double turn_speed = 0.75;
+  double yaw_rate = 0.3;
+  // keep driving past the end of the wall before turning around it; the left
+  // beam already leads the robot, so a long hold overshoots the corner and
+  // the 2.5 m turning circle no longer reaches the wall
+  HoldCondition corner_hold{0.1, 0.15};
+};
+
+struct ControllerState
+{
+  State state = State::APPROACH;
+  std::uint32_t turns = 0;
+  // armed with the index of the edge waiting for its hold condition
+  TransitionHold hold;
+  Odometer odometer;
+};
+
+struct StepResult
+{
+  ControllerState state;
+  Command command;
+};
+
+// What other threads see of a running controller, republished after every
+// step through a Seqlock: progress, contact and the last sector distances.
+struct ControllerSnapshot
+{
+  State state = State::APPROACH;
+  bool touched = false;
+  std::uint32_t turns = 0;
+  std::uint32_t circles = 0;
+  ScanSummary scan{};
+  std::uint64_t steps = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Transition table
+
+using Output = Command (*)(const Config &);
+using Guard = bool (*)(const ScanSummary &, const Config &);
+using Action = void (*)(ControllerState &, Command &);
+
+struct Edge
+{
+  const char * name;
+  State from;
+  State to;
+  Guard guard;
+  Action action;
+  // when set, a firing guard only arms the edge; it is taken once the hold is satisfied
+  HoldCondition Config::* hold;
+};
+
+namespace table
+{
+
+// outputs while in a state
+constexpr Command drive_approach(const Config & c) {return Command{c.approach_speed, 0.0};}
+constexpr Command turn_right(const Config & c) {return Command{0.0, -c.yaw_rate};}
+constexpr Command drive_along(const Config & c) {return Command{c.move_speed, 0.0};}
+constexpr Command turn_left(const Config & c) {return Command{c.turn_speed, c.yaw_rate};}
+constexpr Command halt(const Config &) {return Command{};}
+
+// guards
+constexpr bool wall_ahead(const ScanSummary & s, const Config & c)
+{
+  return s.front < c.approach_distance;
+}
+constexpr bool clear_of_wall(const ScanSummary & s, const Config & c)
+{
+  return s.front > c.open_distance && s.left > c.wall_lost_distance;
+}
+constexpr bool wall_ended(const ScanSummary & s, const Config & c)
+{
+  return s.left > c.open_distance;
+}
+constexpr bool wall_too_close(const ScanSummary & s, const Config & c)
+{
+  return s.left < c.wall_lost_distance;
+}
+constexpr bool wall_found(const ScanSummary & s, const Config & c)
+{
+  return s.left < c.wall_found_distance && s.front > c.open_distance;
+}
+
+// actions
+constexpr void stop(ControllerState &, Command & cmd) {cmd = Command{};}
+constexpr void stop_and_count_turn(ControllerState & s, Command & cmd)
+{
+  cmd = Command{};
+  s.turns++;
+}
+
+}  // namespace table
+
+constexpr std::array<Output, kStateCount> kOutputs{{
+  table::drive_approach,  // APPROACH
+  table::turn_right,      // TURN_RIGHT
+  table::drive_along,     // MOVE_ALONG
+  table::turn_left,       // TURN_LEFT_WALL
+  table::halt,            // ENDED
+  table::halt,            // TOUCHED_WALL
+}};
+
+// Edges of one state are evaluated in table order; the first whose guard holds wins.
+constexpr std::array<Edge, 5> kEdges{{
+  {"approach->turn_right", State::APPROACH, State::TURN_RIGHT,
+    table::wall_ahead, table::stop, nullptr},
+  {"turn_right->move_along", State::TURN_RIGHT, State::MOVE_ALONG,
+    table::clear_of_wall, table::stop, nullptr},
+  {"move_along->turn_left_wall", State::MOVE_ALONG, State::TURN_LEFT_WALL,
+    table::wall_ended, table::stop, &Config::corner_hold},
+  {"move_along->turn_right", State::MOVE_ALONG, State::TURN_RIGHT,
+    table::wall_too_close, table::stop, nullptr},
+  {"turn_left_wall->move_along", State::TURN_LEFT_WALL, State::MOVE_ALONG,
+    table::wall_found, table::stop_and_count_turn, nullptr},
+}};
+
+constexpr std::size_t kEdgeCount = kEdges.size();
+
+// Per-edge counters and per-state entry stamps, updated with relaxed atomics
+// so another thread can read them for profiling without stopping the controller.
+struct TransitionStats
+{
+  std::array<std::atomic<std::uint64_t>, kEdgeCount> taken{};
+  std::array<std::atomic<double>, kStateCount> entered_at{};
+  std::atomic<std::uint64_t> steps{0};
+
+  std::uint64_t edge_count(std::size_t edge) const
+  {
+    return taken[edge].load(std::memory_order_relaxed);
+  }
+
+  double entry_time(State state) const
+  {
+    return entered_at[static_cast<std::size_t>(state)].load(std::memory_order_relaxed);
+  }
+};
+
+namespace detail
+{
+
+struct StepContext
+{
+  StepResult & out;
+  const ScanSummary & scan;
+  double now;
+  const Config & config;
+  TransitionStats * stats;
+  bool done;
+};
+
+template<std::size_t E>
+inline void take_edge(StepContext & ctx)
+{
+  constexpr Edge edge = kEdges[E];
+  ctx.out.state.hold.clear();
+  ctx.out.state.state = edge.to;
+  edge.action(ctx.out.state, ctx.out.command);
+  if (ctx.stats) {
+    ctx.stats->taken[E].fetch_add(1, std::memory_order_relaxed);
+    ctx.stats->entered_at[static_cast<std::size_t>(edge.to)].store(
+      ctx.now, std::memory_order_relaxed);
+  }
+  ctx.done = true;
+}
+
+// Takes a held edge of state S once its hold condition is met.
+template<State S, std::size_t E>
+inline void visit_held_edge(StepContext & ctx)
+{
+  if constexpr (kEdges[E].from == S && kEdges[E].hold != nullptr) {
+    ControllerState & s = ctx.out.state;
+    if (!ctx.done && s.hold.target() == static_cast<int>(E) &&
+      s.hold.satisfied(ctx.now, s.odometer.distance()))
+    {
+      take_edge<E>(ctx);
+    }
+  }
+}
+
+// Evaluates the guard of an edge leaving state S, unrolled at compile time.
+template<State S, std::size_t E>
+inline void visit_edge(StepContext & ctx)
+{
+  if constexpr (kEdges[E].from == S) {
+    constexpr Edge edge = kEdges[E];
+    if (!ctx.done && edge.guard(ctx.scan, ctx.config)) {
+      if constexpr (edge.hold != nullptr) {
+        ControllerState & s = ctx.out.state;
+        s.hold.arm(static_cast<int>(E), ctx.config.*edge.hold, ctx.now, s.odometer.distance());
+        ctx.done = true;
+      } else {
+        take_edge<E>(ctx);
+      }
+    }
+  }
+}
+
+template<State S, std::size_t... E>
+inline void run_state(StepContext & ctx, std::index_sequence<E...>)
+{
+  ctx.out.command = kOutputs[static_cast<std::size_t>(S)](ctx.config);
+  if (ctx.out.state.hold.armed()) {
+    // a pending transition suspends the other edges of the state
+    (visit_held_edge<S, E>(ctx), ...);
+    return;
+  }
+  (visit_edge<S, E>(ctx), ...);
+}
+
+template<State S>
+inline void dispatch_state(StepContext & ctx)
+{
+  run_state<S>(ctx, std::make_index_sequence<kEdgeCount>());
+}
+
+using Dispatch = void (*)(StepContext &);
+
+// One entry per state: the step is a single indexed jump into code with the
+// state's guards and actions inlined.
+constexpr std::array<Dispatch, kStateCount> kDispatch{{
+  dispatch_state<State::APPROACH>,
+  dispatch_state<State::TURN_RIGHT>,
+  dispatch_state<State::MOVE_ALONG>,
+  dispatch_state<State::TURN_LEFT_WALL>,
+  dispatch_state<State::ENDED>,
+  dispatch_state<State::TOUCHED_WALL>,
+}};
+
+}  // namespace detail
+
+// One control step: a pure function of the previous state, the latest scan
+// summary and the current time, with no ROS or middleware in the loop.
+inline StepResult step(
+  const ControllerState & previous, const ScanSummary & scan, double now,
+  const Config & config = Config(), TransitionStats * stats = nullptr)
+{
+  StepResult out{previous, Command()};
+  out.state.odometer.advance(now);
+  detail::StepContext ctx{out, scan, now, config, stats, false};
+  const auto index = static_cast<std::size_t>(previous.state);
+  if (index < kStateCount) {
+    detail::kDispatch[index](ctx);
+  }
+  if (stats) {
+    stats->steps.fetch_add(1, std::memory_order_relaxed);
+  }
+  out.state.odometer.set_speed(out.command.linear_x);
+  return out;
+}
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__CONTROLLER_HPP_
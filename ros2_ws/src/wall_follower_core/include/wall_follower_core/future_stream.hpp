@@ -0,0 +1,90 @@
+#ifndef WALL_FOLLOWER_CORE__FUTURE_STREAM_HPP_
+#define WALL_FOLLOWER_CORE__FUTURE_STREAM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <utility>
+
+namespace wall_follower
+{
+
+// A sequence of values handed out as futures, for a producer that runs in
+// callbacks and a consumer that waits (e.g. in spin_until_future_complete).
+// next() returns the oldest value not taken yet, or a future for the next one
+// to be pushed. After close() every pending and later future completes with
+// the default T (nullptr for a shared_ptr), which marks the end. At most
+// `capacity` values are buffered; past that the oldest is dropped.
+template<typename T>
+class FutureStream
+{
+public:
+  explicit FutureStream(std::size_t capacity = 64)
+  : capacity_(capacity ? capacity : 1) {}
+
+  std::shared_future<T> next()
+  {
+    std::promise<T> promise;
+    auto future = promise.get_future().share();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ready_.empty()) {
+      promise.set_value(std::move(ready_.front()));
+      ready_.pop_front();
+    } else if (closed_) {
+      promise.set_value(T());
+    } else {
+      waiting_.push_back(std::move(promise));
+    }
+    return future;
+  }
+
+  // Producer side; ignored once closed.
+  void push(T value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      return;
+    }
+    if (!waiting_.empty()) {
+      waiting_.front().set_value(std::move(value));
+      waiting_.pop_front();
+      return;
+    }
+    if (ready_.size() == capacity_) {
+      ready_.pop_front();
+      dropped_++;
+    }
+    ready_.push_back(std::move(value));
+  }
+
+  // Ends the stream. Values already buffered are still handed out first.
+  void close()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    for (auto & promise : waiting_) {
+      promise.set_value(T());
+    }
+    waiting_.clear();
+  }
+
+  std::uint64_t dropped() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+  }
+
+private:
+  const std::size_t capacity_;
+  mutable std::mutex mutex_;
+  std::deque<T> ready_;
+  std::deque<std::promise<T>> waiting_;
+  bool closed_ = false;
+  std::uint64_t dropped_ = 0;
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__FUTURE_STREAM_HPP_
@@ -0,0 +1,167 @@
+#ifndef WALL_FOLLOWER_CORE__GOAL_EXECUTOR_HPP_
+#define WALL_FOLLOWER_CORE__GOAL_EXECUTOR_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace wall_follower
+{
+
+// What an action server does with a new goal while every worker is busy.
+enum class GoalPolicy : std::uint8_t
+{
+  REJECT,   // refuse it
+  QUEUE,    // wait for a worker, refuse once the queue is full
+  PREEMPT,  // abort the running goals and take over
+};
+
+inline bool parse_goal_policy(const std::string & name, GoalPolicy & policy)
+{
+  if (name == "reject") {
+    policy = GoalPolicy::REJECT;
+  } else if (name == "queue") {
+    policy = GoalPolicy::QUEUE;
+  } else if (name == "preempt") {
+    policy = GoalPolicy::PREEMPT;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Fixed set of worker threads fed from a bounded FIFO. Threads are created
+// once up front, so a burst of goals costs no thread creation; the pool is
+// joined on shutdown instead of leaving detached threads behind.
+class GoalExecutor
+{
+public:
+  using Job = std::function<void()>;
+
+  GoalExecutor(std::size_t workers, std::size_t queue_capacity)
+  : workers_(workers == 0 ? 1 : workers), capacity_(queue_capacity)
+  {
+    threads_.reserve(workers_);
+    for (std::size_t i = 0; i < workers_; ++i) {
+      threads_.emplace_back(&GoalExecutor::work, this);
+    }
+  }
+
+  ~GoalExecutor()
+  {
+    shutdown();
+  }
+
+  GoalExecutor(const GoalExecutor &) = delete;
+  GoalExecutor & operator=(const GoalExecutor &) = delete;
+
+  // False when the pool is shut down or every worker and queue slot is taken.
+  bool submit(Job job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_ || busy_ + jobs_.size() >= workers_ + capacity_) {
+        return false;
+      }
+      jobs_.push_back(std::move(job));
+    }
+    wake_.notify_one();
+    return true;
+  }
+
+  // Like submit, but past the queue bound: for a goal that has just told every
+  // running and queued one to stop, whose workers it will take over as they
+  // return. False only when the pool is shut down.
+  bool submit_preempting(Job job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        return false;
+      }
+      jobs_.push_back(std::move(job));
+    }
+    wake_.notify_one();
+    return true;
+  }
+
+  // True when a job submitted now would start without waiting.
+  bool has_idle_worker() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !stopping_ && busy_ + jobs_.size() < workers_;
+  }
+
+  bool full() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stopping_ || busy_ + jobs_.size() >= workers_ + capacity_;
+  }
+
+  std::size_t running() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busy_;
+  }
+
+  std::size_t queued() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size();
+  }
+
+  // Stops accepting jobs, lets the workers finish what is running and queued,
+  // then joins them. Jobs are expected to notice the shutdown and return early.
+  void shutdown()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto & thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+  }
+
+private:
+  void work()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [this]() {return stopping_ || !jobs_.empty();});
+      if (jobs_.empty()) {
+        return;
+      }
+      Job job = std::move(jobs_.front());
+      jobs_.pop_front();
+      busy_++;
+      lock.unlock();
+      job();
+      lock.lock();
+      busy_--;
+    }
+  }
+
+  const std::size_t workers_;
+  const std::size_t capacity_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::deque<Job> jobs_;
+  std::size_t busy_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__GOAL_EXECUTOR_HPP_
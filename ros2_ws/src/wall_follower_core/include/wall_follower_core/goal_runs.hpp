@@ -0,0 +1,67 @@
+#ifndef WALL_FOLLOWER_CORE__GOAL_RUNS_HPP_
+#define WALL_FOLLOWER_CORE__GOAL_RUNS_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include "wall_follower_core/controller.hpp"
+
+namespace wall_follower
+{
+
+// Ties the controller's run to the goals driving it. ENDED has no outgoing
+// edge, so once the last goal has stopped the robot the controller waits
+// there; the next goal to start resumes it from the state it was stopped in.
+// Goal threads call start()/finish(); end() and resume() are applied by the
+// control step, which owns the ControllerState.
+class GoalRuns
+{
+public:
+  void start()
+  {
+    running_.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  // True when no other goal is still running, i.e. the caller should stop
+  // the robot and request end().
+  bool finish()
+  {
+    return running_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+  }
+
+  std::uint32_t running() const
+  {
+    return running_.load(std::memory_order_acquire);
+  }
+
+  void end(ControllerState & state)
+  {
+    if (state.state != State::ENDED && state.state != State::TOUCHED_WALL) {
+      paused_ = state.state;
+      state.state = State::ENDED;
+      state.hold.clear();
+    }
+  }
+
+  // Back to where end() left off while a goal is running. A goal that starts
+  // just as another ends still sees the robot move: end() applies first.
+  void resume(ControllerState & state)
+  {
+    if (state.state == State::ENDED && running() > 0) {
+      state.state = paused_;
+    }
+  }
+
+  // A fresh run (activation) starts from APPROACH.
+  void reset()
+  {
+    paused_ = State::APPROACH;
+  }
+
+private:
+  std::atomic<std::uint32_t> running_{0};
+  State paused_ = State::APPROACH;  // control step only
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__GOAL_RUNS_HPP_
@@ -0,0 +1,140 @@
+#ifndef WALL_FOLLOWER_CORE__LATENCY_HISTOGRAM_HPP_
+#define WALL_FOLLOWER_CORE__LATENCY_HISTOGRAM_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace wall_follower
+{
+
+// HDR-style histogram of nanosecond latencies: power-of-two ranges split into
+// 16 linear sub-buckets, so every value is kept to within ~6%. Recording is a
+// few shifts and one relaxed atomic increment; any thread may read at any time.
+class LatencyHistogram
+{
+public:
+  static constexpr int kSubBits = 4;
+  static constexpr std::uint64_t kSubBuckets = 1u << kSubBits;
+  // up to 2^48 ns, about three days
+  static constexpr std::size_t kBuckets = (48 - kSubBits + 1) * kSubBuckets;
+
+  void record(std::int64_t nanoseconds)
+  {
+    const std::uint64_t value = nanoseconds < 0 ? 0 : static_cast<std::uint64_t>(nanoseconds);
+    counts_[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max && !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  std::uint64_t count() const
+  {
+    return total_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t max() const
+  {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  // Upper bound of the bucket holding quantile q (0..1), in nanoseconds.
+  std::uint64_t percentile(double q) const
+  {
+    const std::uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+    const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b) {
+      seen += counts_[b].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        const std::uint64_t upper = upper_bound_of(b);
+        return upper < max() ? upper : max();
+      }
+    }
+    return max();
+  }
+
+private:
+  static std::size_t bucket_of(std::uint64_t value)
+  {
+    if (value < kSubBuckets) {
+      return static_cast<std::size_t>(value);
+    }
+    const int msb = 63 - __builtin_clzll(value);
+    const int shift = msb - kSubBits;
+    const std::size_t index = static_cast<std::size_t>(shift + 1) * kSubBuckets +
+      static_cast<std::size_t>((value >> shift) & (kSubBuckets - 1));
+    return index < kBuckets ? index : kBuckets - 1;
+  }
+
+  static std::uint64_t upper_bound_of(std::size_t bucket)
+  {
+    if (bucket < kSubBuckets) {
+      return bucket;
+    }
+    const std::uint64_t shift = bucket / kSubBuckets - 1;
+    const std::uint64_t sub = bucket % kSubBuckets;
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+  }
+
+  std::array<std::atomic<std::uint64_t>, kBuckets> counts_{};
+  std::atomic<std::uint64_t> total_{0};
+  std::atomic<std::uint64_t> max_{0};
+};
+
+// Scan-to-command latency split into the stages of one control step:
+// receive (scan stamp -> control step starts), decide (analysis and control
+// law) and publish (handing the command to the middleware).
+struct LatencyStages
+{
+  LatencyHistogram receive;
+  LatencyHistogram decide;
+  LatencyHistogram publish;
+
+  // "<stage>_<p50|p99|max>_us" -> value, plus the sample count.
+  std::vector<std::pair<std::string, std::string>> summary() const
+  {
+    std::vector<std::pair<std::string, std::string>> out;
+    out.emplace_back("scans", std::to_string(receive.count()));
+    const std::pair<const char *, const LatencyHistogram *> stages[] = {
+      {"receive", &receive}, {"decide", &decide}, {"publish", &publish}};
+    for (const auto & stage : stages) {
+      const std::string name(stage.first);
+      out.emplace_back(name + "_p50_us", micros(stage.second->percentile(0.5)));
+      out.emplace_back(name + "_p99_us", micros(stage.second->percentile(0.99)));
+      out.emplace_back(name + "_max_us", micros(stage.second->max()));
+    }
+    return out;
+  }
+
+  // The summary as one "key=value ..." line.
+  std::string to_string() const
+  {
+    std::string line;
+    for (const auto & entry : summary()) {
+      line += (line.empty() ? "" : " ") + entry.first + "=" + entry.second;
+    }
+    return line;
+  }
+
+private:
+  static std::string micros(std::uint64_t nanoseconds)
+  {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f", static_cast<double>(nanoseconds) / 1e3);
+    return buffer;
+  }
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__LATENCY_HISTOGRAM_HPP_
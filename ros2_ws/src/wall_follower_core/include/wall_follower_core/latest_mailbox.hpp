@@ -0,0 +1,64 @@
+#ifndef WALL_FOLLOWER_CORE__LATEST_MAILBOX_HPP_
+#define WALL_FOLLOWER_CORE__LATEST_MAILBOX_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+namespace wall_follower
+{
+
+// Single-slot mailbox between one producer and one consumer that only keeps
+// the newest value. It is a triple buffer: post() and take() each swap their
+// private slot with the shared one in a single atomic exchange, so neither
+// side ever waits. A value overwritten before it was taken counts as dropped.
+template<typename T>
+class LatestMailbox
+{
+public:
+  // Producer side. Returns true when an unread value was replaced.
+  bool post(T value)
+  {
+    slots_[back_] = std::move(value);
+    const std::uint8_t previous = shared_.exchange(
+      static_cast<std::uint8_t>(back_ | kFresh), std::memory_order_acq_rel);
+    back_ = previous & kIndex;
+    if (previous & kFresh) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+    return false;
+  }
+
+  // Consumer side. Moves the newest value out if one arrived since the last take.
+  bool take(T & value)
+  {
+    if (!(shared_.load(std::memory_order_relaxed) & kFresh)) {
+      return false;
+    }
+    const std::uint8_t previous = shared_.exchange(front_, std::memory_order_acq_rel);
+    front_ = previous & kIndex;
+    value = std::move(slots_[front_]);
+    return true;
+  }
+
+  std::uint64_t dropped() const
+  {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr std::uint8_t kIndex = 0x3;
+  static constexpr std::uint8_t kFresh = 0x4;
+
+  std::array<T, 3> slots_{};
+  std::uint8_t back_ = 0;
+  std::atomic<std::uint8_t> shared_{1};
+  std::uint8_t front_ = 2;
+  std::atomic<std::uint64_t> dropped_{0};
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__LATEST_MAILBOX_HPP_
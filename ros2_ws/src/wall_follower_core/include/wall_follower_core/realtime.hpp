@@ -0,0 +1,170 @@
+#ifndef WALL_FOLLOWER_CORE__REALTIME_HPP_
+#define WALL_FOLLOWER_CORE__REALTIME_HPP_
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace wall_follower
+{
+
+struct RealtimeOptions
+{
+  // CPU to pin the thread to, -1 leaves the affinity alone
+  int cpu = -1;
+  // SCHED_FIFO priority (1-99), 0 keeps the default scheduler
+  int priority = 0;
+  // mlockall() the process and touch this much stack so the loop never page-faults
+  bool lock_memory = false;
+  std::size_t prefault_stack = 256 * 1024;
+};
+
+namespace detail
+{
+
+inline bool fail(std::string * error, const char * what, int code)
+{
+  if (error) {
+    *error = std::string(what) + ": " + std::strerror(code);
+  }
+  return false;
+}
+
+// noinline so the touched frame really is on the stack of the caller's thread
+__attribute__((noinline)) inline void prefault_stack(std::size_t bytes)
+{
+  volatile unsigned char * frame = static_cast<volatile unsigned char *>(__builtin_alloca(bytes));
+  for (std::size_t i = 0; i < bytes; i += 4096) {
+    frame[i] = 0;
+  }
+}
+
+}  // namespace detail
+
+// Applies the options to the calling thread. On failure the remaining options
+// are still attempted and the first error is reported.
+inline bool configure_current_thread(const RealtimeOptions & options, std::string * error = nullptr)
+{
+  bool ok = true;
+  if (options.lock_memory) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+      ok = detail::fail(error, "mlockall", errno);
+    }
+    detail::prefault_stack(options.prefault_stack);
+  }
+  if (options.cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(options.cpu, &set);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0 && ok) {
+      ok = detail::fail(error, "pthread_setaffinity_np", rc);
+    }
+  }
+  if (options.priority > 0) {
+    sched_param param{};
+    param.sched_priority = options.priority;
+    const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0 && ok) {
+      ok = detail::fail(error, "pthread_setschedparam", rc);
+    }
+  }
+  return ok;
+}
+
+// Counting semaphore to wake a waiting thread; post() is safe from any thread.
+class Wakeup
+{
+public:
+  Wakeup()
+  {
+    sem_init(&sem_, 0, 0);
+  }
+
+  ~Wakeup()
+  {
+    sem_destroy(&sem_);
+  }
+
+  Wakeup(const Wakeup &) = delete;
+  Wakeup & operator=(const Wakeup &) = delete;
+
+  void post()
+  {
+    sem_post(&sem_);
+  }
+
+  // Returns false on timeout. The deadline is on CLOCK_MONOTONIC
+  // (sem_clockwait, glibc 2.30 and later), so wall clock steps from NTP or
+  // date neither stretch nor cut short the wait.
+  bool wait_for(long timeout_ns)
+  {
+    timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_nsec += timeout_ns;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+    deadline.tv_nsec %= 1000000000L;
+    while (sem_clockwait(&sem_, CLOCK_MONOTONIC, &deadline) != 0) {
+      if (errno != EINTR) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  sem_t sem_;
+};
+
+// Mutex with priority inheritance, for a lock shared with a SCHED_FIFO thread:
+// a lower-priority holder is boosted to the waiter's priority until it
+// unlocks, so a thread of middle priority cannot keep the real-time one
+// waiting. Meets BasicLockable, e.g. for std::lock_guard.
+class PiMutex
+{
+public:
+  PiMutex()
+  {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    pthread_mutex_init(&mutex_, &attr);
+    pthread_mutexattr_destroy(&attr);
+  }
+
+  ~PiMutex()
+  {
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  PiMutex(const PiMutex &) = delete;
+  PiMutex & operator=(const PiMutex &) = delete;
+
+  void lock()
+  {
+    pthread_mutex_lock(&mutex_);
+  }
+
+  bool try_lock()
+  {
+    return pthread_mutex_trylock(&mutex_) == 0;
+  }
+
+  void unlock()
+  {
+    pthread_mutex_unlock(&mutex_);
+  }
+
+private:
+  pthread_mutex_t mutex_;
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__REALTIME_HPP_
@@ -0,0 +1,69 @@
+#ifndef WALL_FOLLOWER_CORE__SCAN_ANALYZER_HPP_
+#define WALL_FOLLOWER_CORE__SCAN_ANALYZER_HPP_
+
+#include <array>
+#include <cstddef>
+#include "wall_follower_core/beam_index.hpp"
+#include "wall_follower_core/scan_sectors.hpp"
+
+namespace wall_follower
+{
+
+// What the controller needs to know about one scan.
+struct ScanSummary
+{
+  float front;
+  float left;
+  double stamp;
+};
+
+// Turns raw LaserScan fields into a ScanSummary: sectors are addressed by angle
+// through a cached BeamIndex and reduced with the vector kernel.
+class ScanAnalyzer
+{
+public:
+  enum Sector
+  {
+    FRONT = 0,
+    LEFT = 1,
+    SECTOR_COUNT = 2
+  };
+
+  // straight ahead and 80 degrees to the left, where the wall is followed
+  ScanAnalyzer()
+  : angles_{{{-0.045f, 0.045f}, {1.353f, 1.440f}}}
+  {}
+
+  explicit ScanAnalyzer(const std::array<SectorAngles, SECTOR_COUNT> & angles)
+  : angles_(angles)
+  {}
+
+  ScanSummary analyze(
+    const float * ranges, std::size_t size, float angle_min, float angle_increment,
+    float range_min, float range_max, double stamp)
+  {
+    if (beams_.update(angle_min, angle_increment, size)) {
+      for (std::size_t s = 0; s < SECTOR_COUNT; ++s) {
+        spans_[s] = beams_.span(angles_[s]);
+      }
+    }
+    reduce_sectors(ranges, size, range_min, range_max, spans_.data(), SECTOR_COUNT, sectors_.data());
+    return ScanSummary{sectors_[FRONT].min, sectors_[LEFT].min, stamp};
+  }
+
+  // Full summaries of the last analyzed scan.
+  const std::array<SectorSummary, SECTOR_COUNT> & sectors() const
+  {
+    return sectors_;
+  }
+
+private:
+  std::array<SectorAngles, SECTOR_COUNT> angles_;
+  BeamIndex beams_;
+  std::array<SectorSpan, SECTOR_COUNT> spans_{};
+  std::array<SectorSummary, SECTOR_COUNT> sectors_{};
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__SCAN_ANALYZER_HPP_
@@ -0,0 +1,187 @@
+#ifndef WALL_FOLLOWER_CORE__SCAN_SECTORS_HPP_
+#define WALL_FOLLOWER_CORE__SCAN_SECTORS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace wall_follower
+{
+
+// Half-open range of beam indices [begin, end) reduced into one summary.
+struct SectorSpan
+{
+  std::size_t begin;
+  std::size_t end;
+};
+
+// Statistics over the valid returns of a sector. A sector without valid returns
+// reports +inf for min and mean, which reads as open space to the controllers.
+struct SectorSummary
+{
+  float min;
+  float mean;
+  std::uint32_t valid;
+};
+
+namespace detail
+{
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+
+inline SectorSummary finish(float min, float sum, std::uint32_t valid)
+{
+  return SectorSummary{min, valid > 0 ? sum / static_cast<float>(valid) : kInf, valid};
+}
+
+// A return is valid when range_min <= r <= range_max; the ordered comparisons
+// reject NaN and the upper bound rejects inf.
+inline void reduce_scalar(
+  const float * ranges, std::size_t begin, std::size_t end,
+  float range_min, float range_max, float & min, float & sum, std::uint32_t & valid)
+{
+  for (std::size_t i = begin; i < end; ++i) {
+    const float r = ranges[i];
+    if (r >= range_min && r <= range_max) {
+      min = r < min ? r : min;
+      sum += r;
+      ++valid;
+    }
+  }
+}
+
+inline SectorSummary reduce_span_scalar(
+  const float * ranges, std::size_t begin, std::size_t end, float range_min, float range_max)
+{
+  float min = kInf;
+  float sum = 0.0f;
+  std::uint32_t valid = 0;
+  reduce_scalar(ranges, begin, end, range_min, range_max, min, sum, valid);
+  return finish(min, sum, valid);
+}
+
+#if defined(__AVX2__)
+
+constexpr const char * kKernelName = "avx2";
+
+inline SectorSummary reduce_span_simd(
+  const float * ranges, std::size_t begin, std::size_t end, float range_min, float range_max)
+{
+  const __m256 lo = _mm256_set1_ps(range_min);
+  const __m256 hi = _mm256_set1_ps(range_max);
+  const __m256 inf = _mm256_set1_ps(kInf);
+  __m256 vmin = inf;
+  __m256 vsum = _mm256_setzero_ps();
+  __m256i vcount = _mm256_setzero_si256();
+  std::size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    const __m256 r = _mm256_loadu_ps(ranges + i);
+    const __m256 ok = _mm256_and_ps(
+      _mm256_cmp_ps(r, lo, _CMP_GE_OQ), _mm256_cmp_ps(r, hi, _CMP_LE_OQ));
+    vmin = _mm256_min_ps(vmin, _mm256_blendv_ps(inf, r, ok));
+    vsum = _mm256_add_ps(vsum, _mm256_and_ps(r, ok));
+    // a true lane is all ones, i.e. -1 as an integer
+    vcount = _mm256_sub_epi32(vcount, _mm256_castps_si256(ok));
+  }
+  alignas(32) float mins[8];
+  alignas(32) float sums[8];
+  alignas(32) std::int32_t counts[8];
+  _mm256_store_ps(mins, vmin);
+  _mm256_store_ps(sums, vsum);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(counts), vcount);
+  float min = kInf;
+  float sum = 0.0f;
+  std::uint32_t valid = 0;
+  for (int lane = 0; lane < 8; ++lane) {
+    min = mins[lane] < min ? mins[lane] : min;
+    sum += sums[lane];
+    valid += static_cast<std::uint32_t>(counts[lane]);
+  }
+  reduce_scalar(ranges, i, end, range_min, range_max, min, sum, valid);
+  return finish(min, sum, valid);
+}
+
+#elif defined(__SSE2__)
+
+constexpr const char * kKernelName = "sse2";
+
+inline SectorSummary reduce_span_simd(
+  const float * ranges, std::size_t begin, std::size_t end, float range_min, float range_max)
+{
+  const __m128 lo = _mm_set1_ps(range_min);
+  const __m128 hi = _mm_set1_ps(range_max);
+  const __m128 inf = _mm_set1_ps(kInf);
+  __m128 vmin = inf;
+  __m128 vsum = _mm_setzero_ps();
+  __m128i vcount = _mm_setzero_si128();
+  std::size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    const __m128 r = _mm_loadu_ps(ranges + i);
+    const __m128 ok = _mm_and_ps(_mm_cmpge_ps(r, lo), _mm_cmple_ps(r, hi));
+    vmin = _mm_min_ps(vmin, _mm_or_ps(_mm_and_ps(ok, r), _mm_andnot_ps(ok, inf)));
+    vsum = _mm_add_ps(vsum, _mm_and_ps(r, ok));
+    // a true lane is all ones, i.e. -1 as an integer
+    vcount = _mm_sub_epi32(vcount, _mm_castps_si128(ok));
+  }
+  alignas(16) float mins[4];
+  alignas(16) float sums[4];
+  alignas(16) std::int32_t counts[4];
+  _mm_store_ps(mins, vmin);
+  _mm_store_ps(sums, vsum);
+  _mm_store_si128(reinterpret_cast<__m128i *>(counts), vcount);
+  float min = kInf;
+  float sum = 0.0f;
+  std::uint32_t valid = 0;
+  for (int lane = 0; lane < 4; ++lane) {
+    min = mins[lane] < min ? mins[lane] : min;
+    sum += sums[lane];
+    valid += static_cast<std::uint32_t>(counts[lane]);
+  }
+  reduce_scalar(ranges, i, end, range_min, range_max, min, sum, valid);
+  return finish(min, sum, valid);
+}
+
+#else
+
+constexpr const char * kKernelName = "scalar";
+
+inline SectorSummary reduce_span_simd(
+  const float * ranges, std::size_t begin, std::size_t end, float range_min, float range_max)
+{
+  return reduce_span_scalar(ranges, begin, end, range_min, range_max);
+}
+
+#endif
+
+}  // namespace detail
+
+// Name of the kernel selected at compile time: "avx2", "sse2" or "scalar".
+inline const char * sector_kernel_name()
+{
+  return detail::kKernelName;
+}
+
+// Reduces every sector of a scan, one vector pass per sector over that
+// sector's span only; beams outside every span are never read, and a beam in
+// overlapping spans is read once per span. Spans are clamped to the scan size
+// so a shorter scan never reads out of bounds.
+inline void reduce_sectors(
+  const float * ranges, std::size_t size, float range_min, float range_max,
+  const SectorSpan * spans, std::size_t count, SectorSummary * out)
+{
+  for (std::size_t s = 0; s < count; ++s) {
+    const std::size_t end = spans[s].end < size ? spans[s].end : size;
+    const std::size_t begin = spans[s].begin < end ? spans[s].begin : end;
+    out[s] = detail::reduce_span_simd(ranges, begin, end, range_min, range_max);
+  }
+}
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__SCAN_SECTORS_HPP_
@@ -0,0 +1,113 @@
+#ifndef WALL_FOLLOWER_CORE__SEQLOCK_HPP_
+#define WALL_FOLLOWER_CORE__SEQLOCK_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace wall_follower
+{
+
+// Sequence lock around a small trivially copyable value. Readers never block
+// a writer and never write shared memory: they copy the value and retry if a
+// write overlapped. Writers take the sequence from even to odd with a CAS, so
+// several writer threads may share one instance; they only wait for each
+// other, never for readers. The value is kept as atomic words so the racing
+// copy is well defined. Word stores are release and word loads acquire rather
+// than relaxed plus fences: a reader that sees any word of an overlapping
+// write also sees that write's odd sequence. On x86 these are plain moves, and
+// ThreadSanitizer, which does not model fences, understands them.
+template<typename T>
+class Seqlock
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Seqlock needs a trivially copyable type");
+
+public:
+  Seqlock()
+  {
+    store_words(T{});
+  }
+
+  explicit Seqlock(const T & value)
+  {
+    store_words(value);
+  }
+
+  T load() const
+  {
+    for (;;) {
+      const std::uint64_t before = seq_.load(std::memory_order_acquire);
+      if (before & 1u) {
+        continue;
+      }
+      const T value = load_words();
+      if (seq_.load(std::memory_order_relaxed) == before) {
+        return value;
+      }
+    }
+  }
+
+  void store(const T & value)
+  {
+    update([&value](T & current) {current = value;});
+  }
+
+  // Read-modify-write under the writer lock, e.g. to set a single field.
+  template<typename F>
+  void update(F && modify)
+  {
+    std::uint64_t seq = seq_.load(std::memory_order_relaxed);
+    for (;;) {
+      if (!(seq & 1u) &&
+        seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire,
+        std::memory_order_relaxed))
+      {
+        break;
+      }
+      seq = seq_.load(std::memory_order_relaxed);
+    }
+    T value = load_words();
+    modify(value);
+    store_words(value);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  // Number of completed writes.
+  std::uint64_t version() const
+  {
+    return seq_.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) /
+    sizeof(std::uint64_t);
+
+  T load_words() const
+  {
+    std::array<std::uint64_t, kWords> words;
+    for (std::size_t i = 0; i < kWords; ++i) {
+      words[i] = words_[i].load(std::memory_order_acquire);
+    }
+    T value;
+    std::memcpy(static_cast<void *>(&value), words.data(), sizeof(T));
+    return value;
+  }
+
+  void store_words(const T & value)
+  {
+    std::array<std::uint64_t, kWords> words{};
+    std::memcpy(words.data(), static_cast<const void *>(&value), sizeof(T));
+    for (std::size_t i = 0; i < kWords; ++i) {
+      words_[i].store(words[i], std::memory_order_release);
+    }
+  }
+
+  std::atomic<std::uint64_t> seq_{0};
+  std::array<std::atomic<std::uint64_t>, kWords> words_{};
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__SEQLOCK_HPP_
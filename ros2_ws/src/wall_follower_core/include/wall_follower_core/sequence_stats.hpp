@@ -0,0 +1,166 @@
+#ifndef WALL_FOLLOWER_CORE__SEQUENCE_STATS_HPP_
+#define WALL_FOLLOWER_CORE__SEQUENCE_STATS_HPP_
+
+#include <bitset>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "wall_follower_core/latency_histogram.hpp"
+
+namespace wall_follower
+{
+
+// Link health of a stream whose messages carry an increasing sequence number.
+// A jump forward counts the skipped numbers as lost (one gap); a number that
+// shows up at most reorder_tolerance behind the highest one is a reorder and
+// no longer lost, or a duplicate when it was seen before. Any jump further
+// back means the sender restarted, and counting starts over from it.
+// Inter-arrival times go into a histogram and a running inter-arrival jitter:
+// how much each interval differs from the previous one, smoothed with gain
+// 1/16. Not thread-safe: record and summarise from one thread.
+class SequenceStats
+{
+public:
+  static constexpr std::int64_t kWindow = 1024;
+
+  // Throws std::invalid_argument unless 0 <= reorder_tolerance < kWindow.
+  explicit SequenceStats(std::int64_t reorder_tolerance = 16)
+  : tolerance_(reorder_tolerance)
+  {
+    if (reorder_tolerance < 0 || reorder_tolerance >= kWindow) {
+      throw std::invalid_argument("reorder_tolerance must be in [0, 1023]");
+    }
+  }
+
+  void record(std::int64_t seq, std::int64_t arrival_ns)
+  {
+    received_++;
+    window_received_++;
+    if (window_start_ns_ == 0) {
+      window_start_ns_ = arrival_ns;
+    }
+    if (last_arrival_ns_ != 0) {
+      const std::int64_t interval = arrival_ns - last_arrival_ns_;
+      interval_->record(interval);
+      if (last_interval_ns_ != 0) {
+        const double deviation = std::abs(static_cast<double>(interval - last_interval_ns_));
+        jitter_ns_ += (deviation - jitter_ns_) / 16.0;
+      }
+      last_interval_ns_ = interval;
+    }
+    last_arrival_ns_ = arrival_ns;
+
+    if (received_ == 1) {
+      restart_at(seq);
+      return;
+    }
+    if (seq > highest_) {
+      const std::int64_t gap = seq - highest_ - 1;
+      if (gap >= kWindow) {
+        seen_.reset();
+      } else {
+        for (std::int64_t s = highest_ + 1; s < seq; ++s) {
+          seen_.reset(slot(s));
+        }
+      }
+      if (gap > 0) {
+        lost_ += static_cast<std::uint64_t>(gap);
+        gaps_++;
+      }
+      seen_.set(slot(seq));
+      highest_ = seq;
+    } else if (highest_ - seq <= tolerance_) {
+      if (seen_.test(slot(seq))) {
+        duplicates_++;
+      } else {
+        seen_.set(slot(seq));
+        reordered_++;
+        // numbers from before the first one seen were never counted as lost
+        if (seq > first_) {
+          lost_--;
+        }
+      }
+    } else {
+      restarts_++;
+      restart_at(seq);
+    }
+  }
+
+  std::uint64_t received() const {return received_;}
+  std::uint64_t lost() const {return lost_;}
+  std::uint64_t gaps() const {return gaps_;}
+  std::uint64_t reordered() const {return reordered_;}
+  std::uint64_t duplicates() const {return duplicates_;}
+  std::uint64_t restarts() const {return restarts_;}
+
+  // Totals, plus the rate and inter-arrival percentiles since the previous
+  // call, which starts the next window.
+  std::vector<std::pair<std::string, std::string>> summary(std::int64_t now_ns)
+  {
+    std::vector<std::pair<std::string, std::string>> out;
+    out.emplace_back("received", std::to_string(received_));
+    out.emplace_back("lost", std::to_string(lost_));
+    out.emplace_back("gaps", std::to_string(gaps_));
+    out.emplace_back("reordered", std::to_string(reordered_));
+    out.emplace_back("duplicates", std::to_string(duplicates_));
+    out.emplace_back("restarts", std::to_string(restarts_));
+    const double seconds = (now_ns - window_start_ns_) / 1e9;
+    out.emplace_back("rate_hz", format(seconds > 0.0 ? window_received_ / seconds : 0.0));
+    out.emplace_back("interval_p50_us", format(interval_->percentile(0.5) / 1e3));
+    out.emplace_back("interval_p99_us", format(interval_->percentile(0.99) / 1e3));
+    out.emplace_back("interval_max_us", format(interval_->max() / 1e3));
+    out.emplace_back("interarrival_jitter_us", format(jitter_ns_ / 1e3));
+    window_start_ns_ = now_ns;
+    window_received_ = 0;
+    interval_ = std::make_unique<LatencyHistogram>();
+    return out;
+  }
+
+private:
+  static std::size_t slot(std::int64_t seq)
+  {
+    return static_cast<std::size_t>(static_cast<std::uint64_t>(seq) % kWindow);
+  }
+
+  static std::string format(double value)
+  {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.1f", value);
+    return buffer;
+  }
+
+  void restart_at(std::int64_t seq)
+  {
+    seen_.reset();
+    seen_.set(slot(seq));
+    first_ = seq;
+    highest_ = seq;
+  }
+
+  std::int64_t tolerance_;
+  std::bitset<kWindow> seen_;
+  std::int64_t first_ = 0;
+  std::int64_t highest_ = 0;
+  std::uint64_t received_ = 0;
+  std::uint64_t lost_ = 0;
+  std::uint64_t gaps_ = 0;
+  std::uint64_t reordered_ = 0;
+  std::uint64_t duplicates_ = 0;
+  std::uint64_t restarts_ = 0;
+
+  std::int64_t last_arrival_ns_ = 0;
+  std::int64_t last_interval_ns_ = 0;
+  double jitter_ns_ = 0.0;
+  std::int64_t window_start_ns_ = 0;
+  std::uint64_t window_received_ = 0;
+  std::unique_ptr<LatencyHistogram> interval_ = std::make_unique<LatencyHistogram>();
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__SEQUENCE_STATS_HPP_
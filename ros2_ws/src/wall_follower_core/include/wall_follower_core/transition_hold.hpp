@@ -0,0 +1,100 @@
+#ifndef WALL_FOLLOWER_CORE__TRANSITION_HOLD_HPP_
+#define WALL_FOLLOWER_CORE__TRANSITION_HOLD_HPP_
+
+namespace wall_follower
+{
+
+// How long a pending transition is held before it is taken. Zero disables a
+// limit; when both are set the transition fires on whichever is reached first.
+struct HoldCondition
+{
+  double seconds = 0.0;
+  double metres = 0.0;
+};
+
+// Distance travelled, dead-reckoned from the commanded forward speed between
+// consecutive scan stamps.
+class Odometer
+{
+public:
+  // Integrates the last commanded speed up to stamp.
+  void advance(double stamp)
+  {
+    if (started_ && stamp > last_stamp_) {
+      distance_ += speed_ * (stamp - last_stamp_);
+    }
+    started_ = true;
+    last_stamp_ = stamp;
+  }
+
+  void set_speed(double commanded_speed)
+  {
+    speed_ = commanded_speed < 0.0 ? -commanded_speed : commanded_speed;
+  }
+
+  double distance() const
+  {
+    return distance_;
+  }
+
+private:
+  bool started_ = false;
+  double last_stamp_ = 0.0;
+  double speed_ = 0.0;
+  double distance_ = 0.0;
+};
+
+// A state transition that has been triggered but must wait for its hold
+// condition. It is polled from later callbacks instead of blocking the current one.
+class TransitionHold
+{
+public:
+  void arm(int target, const HoldCondition & condition, double now, double odometer)
+  {
+    armed_ = true;
+    target_ = target;
+    condition_ = condition;
+    start_time_ = now;
+    start_distance_ = odometer;
+  }
+
+  void clear()
+  {
+    armed_ = false;
+  }
+
+  bool armed() const
+  {
+    return armed_;
+  }
+
+  int target() const
+  {
+    return target_;
+  }
+
+  bool satisfied(double now, double odometer) const
+  {
+    if (!armed_) {
+      return false;
+    }
+    if (condition_.seconds <= 0.0 && condition_.metres <= 0.0) {
+      return true;
+    }
+    if (condition_.seconds > 0.0 && now - start_time_ >= condition_.seconds) {
+      return true;
+    }
+    return condition_.metres > 0.0 && odometer - start_distance_ >= condition_.metres;
+  }
+
+private:
+  bool armed_ = false;
+  int target_ = 0;
+  HoldCondition condition_;
+  double start_time_ = 0.0;
+  double start_distance_ = 0.0;
+};
+
+}  // namespace wall_follower
+
+#endif  // WALL_FOLLOWER_CORE__TRANSITION_HOLD_HPP_
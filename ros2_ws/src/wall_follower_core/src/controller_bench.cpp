@@ -0,0 +1,132 @@
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/scan_analyzer.hpp"
+
+using wall_follower::ScanSummary;
+using wall_follower::State;
+
+namespace
+{
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr double kScanPeriod = 0.1;
+
+// Synthetic surroundings that walk the controller around its whole cycle: every
+// fifth scan in a state shows what triggers the next transition.
+enum Pattern
+{
+  OPEN = 0,
+  WALL_AHEAD = 1,
+  WALL_BESIDE = 2,
+  WALL_TURNING = 3,
+  PATTERN_COUNT = 4
+};
+
+Pattern pattern_for(State state, std::uint64_t tick)
+{
+  const bool trigger = tick % 5 == 4;
+  switch (state) {
+    case State::APPROACH:
+      return trigger ? WALL_AHEAD : OPEN;
+    case State::TURN_RIGHT:
+      return trigger ? WALL_BESIDE : WALL_TURNING;
+    case State::MOVE_ALONG:
+      return trigger ? OPEN : WALL_BESIDE;
+    case State::TURN_LEFT_WALL:
+      return trigger ? WALL_BESIDE : OPEN;
+    default:
+      return OPEN;
+  }
+}
+
+const std::array<ScanSummary, PATTERN_COUNT> kSummaries{{
+  {kInf, kInf, 0.0},
+  {0.8f, kInf, 0.0},
+  {kInf, 2.05f, 0.0},
+  {3.0f, 3.0f, 0.0},
+}};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+// Drives the controller headless with synthetic scans.
+//   controller_bench [iterations] [min_steps_per_second]
+// Exits non-zero when the step-only rate falls below the given minimum.
+int main(int argc, char * argv[])
+{
+  const std::uint64_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+  const double min_rate = argc > 2 ? std::atof(argv[2]) : 0.0;
+  const wall_follower::Config config;
+
+  // 1) control law only
+  wall_follower::ControllerState state;
+  double sink = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < iterations; ++i) {
+    ScanSummary scan = kSummaries[pattern_for(state.state, i)];
+    scan.stamp = static_cast<double>(i) * kScanPeriod;
+    const auto result = wall_follower::step(state, scan, scan.stamp, config);
+    state = result.state;
+    sink += result.command.linear_x;
+  }
+  const double step_rate = static_cast<double>(iterations) / seconds_since(start);
+  std::printf(
+    "step:          %12.0f steps/s  %7.1f ns/step  turns=%u\n",
+    step_rate, 1e9 / step_rate, state.turns);
+
+  // 2) 640-beam scan analysis followed by the control law
+  const std::size_t beams = 640;
+  const float angle_min = -1.396263f;
+  const float angle_increment = 2.0f * 1.396263f / static_cast<float>(beams - 1);
+  std::array<std::vector<float>, PATTERN_COUNT> scans;
+  for (std::size_t p = 0; p < PATTERN_COUNT; ++p) {
+    scans[p].assign(beams, kInf);
+    for (std::size_t b = 305; b < 335; ++b) {
+      scans[p][b] = kSummaries[p].front;
+    }
+    for (std::size_t b = 620; b < beams; ++b) {
+      scans[p][b] = kSummaries[p].left;
+    }
+  }
+  wall_follower::ScanAnalyzer analyzer;
+  wall_follower::TransitionStats stats;
+  state = wall_follower::ControllerState();
+  const std::uint64_t pipeline_iterations = iterations / 10;
+  start = std::chrono::steady_clock::now();
+  for (std::uint64_t i = 0; i < pipeline_iterations; ++i) {
+    const auto & ranges = scans[pattern_for(state.state, i)];
+    const double stamp = static_cast<double>(i) * kScanPeriod;
+    const auto scan = analyzer.analyze(
+      ranges.data(), ranges.size(), angle_min, angle_increment, 0.12f, 10.0f, stamp);
+    const auto result = wall_follower::step(state, scan, stamp, config, &stats);
+    state = result.state;
+    sink += result.command.linear_x;
+  }
+  const double pipeline_rate = static_cast<double>(pipeline_iterations) / seconds_since(start);
+  std::printf(
+    "analyze+step:  %12.0f scans/s  %7.1f ns/scan  turns=%u  kernel=%s\n",
+    pipeline_rate, 1e9 / pipeline_rate, state.turns, wall_follower::sector_kernel_name());
+  for (std::size_t e = 0; e < wall_follower::kEdgeCount; ++e) {
+    std::printf(
+      "  %-28s taken %10llu\n", wall_follower::kEdges[e].name,
+      static_cast<unsigned long long>(stats.edge_count(e)));
+  }
+
+  if (sink < 0.0) {
+    return 2;
+  }
+  if (min_rate > 0.0 && step_rate < min_rate) {
+    std::fprintf(stderr, "step rate %.0f below required %.0f\n", step_rate, min_rate);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/realtime.hpp"
+#include "wall_follower_core/scan_analyzer.hpp"
+#include "wall_follower_core/spsc_queue.hpp"
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+std::int64_t now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    Clock::now().time_since_epoch()).count();
+}
+
+struct Phase
+{
+  const char * name;
+  wall_follower::RealtimeOptions options;
+};
+
+// Feeds stamped "scans" at 1 kHz through the SPSC queue to a control thread
+// while load_threads spin on every core, and returns the stamp -> command
+// latencies seen by the control thread in nanoseconds.
+std::vector<std::int64_t> run_phase(const Phase & phase, double seconds, int load_threads)
+{
+  const std::size_t beams = 640;
+  const float angle_increment = 2.0f * 1.396263f / static_cast<float>(beams - 1);
+  std::vector<float> ranges(beams, std::numeric_limits<float>::infinity());
+
+  wall_follower::SpscQueue<std::int64_t, 16> queue;
+  wall_follower::Wakeup wakeup;
+  std::atomic<bool> running{true};
+  std::atomic<bool> ready{false};
+  std::vector<std::int64_t> latencies;
+  latencies.reserve(static_cast<std::size_t>(seconds * 1000.0) + 16);
+
+  std::vector<std::thread> load;
+  for (int i = 0; i < load_threads; ++i) {
+    load.emplace_back(
+      [&running]() {
+        volatile std::uint64_t spin = 0;
+        while (running.load(std::memory_order_relaxed)) {
+          spin = spin + 1;
+        }
+      });
+  }
+
+  std::thread control(
+    [&]() {
+      std::string error;
+      if (!wall_follower::configure_current_thread(phase.options, &error)) {
+        std::fprintf(stderr, "%s: realtime setup incomplete (%s)\n", phase.name, error.c_str());
+      }
+      wall_follower::ScanAnalyzer analyzer;
+      wall_follower::ControllerState state;
+      ready.store(true);
+      while (running.load(std::memory_order_relaxed)) {
+        if (!wakeup.wait_for(10000000L)) {
+          continue;
+        }
+        std::int64_t stamp = 0;
+        std::int64_t freshest = 0;
+        while (queue.pop(stamp)) {
+          freshest = stamp;
+        }
+        if (freshest == 0) {
+          continue;
+        }
+        const auto scan = analyzer.analyze(
+          ranges.data(), ranges.size(), -1.396263f, angle_increment, 0.12f, 10.0f,
+          static_cast<double>(freshest) * 1e-9);
+        state = wall_follower::step(state, scan, scan.stamp).state;
+        latencies.push_back(now_ns() - freshest);
+      }
+    });
+
+  while (!ready.load()) {
+    std::this_thread::yield();
+  }
+  const auto period = std::chrono::milliseconds(1);
+  auto next = Clock::now() + period;
+  const auto end = Clock::now() + std::chrono::duration<double>(seconds);
+  while (Clock::now() < end) {
+    std::this_thread::sleep_until(next);
+    next += period;
+    std::int64_t stamp = now_ns();
+    if (queue.push(std::move(stamp))) {
+      wakeup.post();
+    }
+  }
+  running.store(false);
+  wakeup.post();
+  control.join();
+  for (auto & t : load) {
+    t.join();
+  }
+  return latencies;
+}
+
+void report(const char * name, std::vector<std::int64_t> latencies)
+{
+  if (latencies.empty()) {
+    std::printf("%-9s no samples\n", name);
+    return;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const auto at = [&latencies](double q) {
+      return static_cast<double>(
+        latencies[static_cast<std::size_t>(q * static_cast<double>(latencies.size() - 1))]) / 1e3;
+    };
+  std::printf(
+    "%-9s samples=%6zu  p50=%8.1f us  p99=%8.1f us  p99.9=%8.1f us  max=%8.1f us\n",
+    name, latencies.size(), at(0.5), at(0.99), at(0.999), at(1.0));
+}
+
+}  // namespace
+
+// Scan-to-command latency of the control thread under CPU load, with the
+// default scheduler and with the realtime options used by circle_wall.
+//   rt_jitter_bench [seconds] [load_threads] [cpu] [priority]
+// SCHED_FIFO and mlockall need CAP_SYS_NICE / CAP_IPC_LOCK (or rtprio limits).
+int main(int argc, char * argv[])
+{
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+  const int load_threads = argc > 2 ? std::atoi(argv[2]) :
+    static_cast<int>(std::thread::hardware_concurrency());
+  wall_follower::RealtimeOptions realtime;
+  realtime.cpu = argc > 3 ? std::atoi(argv[3]) : 0;
+  realtime.priority = argc > 4 ? std::atoi(argv[4]) : 80;
+  realtime.lock_memory = true;
+
+  std::printf(
+    "%.1f s per phase, %d load threads, realtime cpu=%d priority=%d\n",
+    seconds, load_threads, realtime.cpu, realtime.priority);
+  const Phase phases[] = {
+    {"default", wall_follower::RealtimeOptions()},
+    {"realtime", realtime},
+  };
+  for (const auto & phase : phases) {
+    report(phase.name, run_phase(phase, seconds, load_threads));
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+#include "wall_follower_core/scan_sectors.hpp"
+
+// Times the sector reduction over a synthetic 640-beam scan with NaN and inf
+// returns mixed in, and checks the vector kernel against the scalar one.
+int main(int argc, char * argv[])
+{
+  const std::size_t scan_size = 640;
+  const long iterations = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> range(0.2f, 12.0f);
+  std::uniform_int_distribution<int> fault(0, 19);
+  std::vector<float> ranges(scan_size);
+  for (auto & r : ranges) {
+    const int f = fault(rng);
+    if (f == 0) {
+      r = std::numeric_limits<float>::quiet_NaN();
+    } else if (f == 1) {
+      r = std::numeric_limits<float>::infinity();
+    } else {
+      r = range(rng);
+    }
+  }
+  const float range_min = 0.12f;
+  const float range_max = 10.0f;
+
+  // full scan split into eight 80-beam sectors
+  std::array<wall_follower::SectorSpan, 8> spans;
+  for (std::size_t s = 0; s < spans.size(); ++s) {
+    spans[s] = {s * scan_size / spans.size(), (s + 1) * scan_size / spans.size()};
+  }
+  std::array<wall_follower::SectorSummary, 8> out;
+
+  wall_follower::reduce_sectors(
+    ranges.data(), ranges.size(), range_min, range_max, spans.data(), spans.size(), out.data());
+  for (std::size_t s = 0; s < spans.size(); ++s) {
+    const auto ref = wall_follower::detail::reduce_span_scalar(
+      ranges.data(), spans[s].begin, spans[s].end, range_min, range_max);
+    if (ref.valid != out[s].valid || ref.min != out[s].min ||
+      std::fabs(ref.mean - out[s].mean) > 1e-4f * ref.mean)
+    {
+      std::fprintf(stderr, "sector %zu mismatch against scalar kernel\n", s);
+      return 1;
+    }
+  }
+
+  float sink = 0.0f;
+  const auto start = std::chrono::steady_clock::now();
+  for (long i = 0; i < iterations; ++i) {
+    // perturb one beam so the work cannot be hoisted out of the loop
+    ranges[static_cast<std::size_t>(i) % scan_size] += 0.0f * sink;
+    wall_follower::reduce_sectors(
+      ranges.data(), ranges.size(), range_min, range_max, spans.data(), spans.size(), out.data());
+    sink += out[0].min;
+  }
+  const auto elapsed = std::chrono::duration<double, std::nano>(
+    std::chrono::steady_clock::now() - start).count();
+
+  std::printf(
+    "kernel=%s beams=%zu sectors=%zu iterations=%ld ns_per_scan=%.1f (sink %g)\n",
+    wall_follower::sector_kernel_name(), scan_size, spans.size(), iterations,
+    elapsed / static_cast<double>(iterations), static_cast<double>(sink));
+  return 0;
+}
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/seqlock.hpp"
+
+// Hammers a Seqlock<ControllerSnapshot> the way circle_wall_server does: one
+// control thread publishing every step, a contact thread setting a single
+// field and several readers. Every published snapshot is internally
+// consistent (all fields derive from steps), so any torn read is detected.
+// Build with -fsanitize=thread to check the memory model side as well.
+//   snapshot_stress [seconds] [readers]
+int main(int argc, char * argv[])
+{
+  const double seconds = argc > 1 ? std::atof(argv[1]) : 2.0;
+  const int readers = argc > 2 ? std::atoi(argv[2]) :
+    std::max(2, static_cast<int>(std::thread::hardware_concurrency()) - 2);
+
+  wall_follower::Seqlock<wall_follower::ControllerSnapshot> snapshot;
+  std::atomic<bool> running{true};
+  std::atomic<std::uint64_t> torn{0};
+  std::atomic<std::uint64_t> reads{0};
+  std::uint64_t writes = 0;
+
+  const auto consistent = [](const wall_follower::ControllerSnapshot & s) {
+      const auto n = s.steps;
+      return s.turns == static_cast<std::uint32_t>(n) &&
+             s.circles == static_cast<std::uint32_t>(n / 2) &&
+             s.state == static_cast<wall_follower::State>(n % 4) &&
+             s.scan.front == static_cast<float>(n % 1000) &&
+             s.scan.left == -static_cast<float>(n % 1000) &&
+             s.scan.stamp == static_cast<double>(n);
+    };
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < readers; ++i) {
+    threads.emplace_back(
+      [&]() {
+        std::uint64_t local = 0;
+        std::uint64_t last_steps = 0;
+        while (running.load(std::memory_order_relaxed)) {
+          const auto s = snapshot.load();
+          // torn, or going backwards in time
+          if (!consistent(s) || s.steps < last_steps) {
+            torn.fetch_add(1, std::memory_order_relaxed);
+          }
+          last_steps = s.steps;
+          local++;
+        }
+        reads.fetch_add(local, std::memory_order_relaxed);
+      });
+  }
+  threads.emplace_back(
+    [&]() {
+      while (running.load(std::memory_order_relaxed)) {
+        snapshot.update([](wall_follower::ControllerSnapshot & s) {s.touched = !s.touched;});
+        std::this_thread::yield();
+      }
+    });
+
+  const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+  while (std::chrono::steady_clock::now() < end) {
+    for (int i = 0; i < 1000; ++i) {
+      const std::uint64_t n = ++writes;
+      snapshot.update(
+        [n](wall_follower::ControllerSnapshot & s) {
+          s.steps = n;
+          s.turns = static_cast<std::uint32_t>(n);
+          s.circles = static_cast<std::uint32_t>(n / 2);
+          s.state = static_cast<wall_follower::State>(n % 4);
+          s.scan.front = static_cast<float>(n % 1000);
+          s.scan.left = -static_cast<float>(n % 1000);
+          s.scan.stamp = static_cast<double>(n);
+        });
+    }
+  }
+  running.store(false);
+  for (auto & t : threads) {
+    t.join();
+  }
+
+  std::printf(
+    "%d readers, %.1f s: %.2f M writes/s, %.2f M reads/s, %lu torn reads\n",
+    readers, seconds, static_cast<double>(writes) / seconds / 1e6,
+    static_cast<double>(reads.load()) / seconds / 1e6,
+    static_cast<unsigned long>(torn.load()));
+  return torn.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include "wall_follower_core/beam_index.hpp"
+
+namespace
+{
+
+constexpr float kPi = 3.14159265358979f;
+
+// The simulator's lidar: 640 beams over [-80, 80] degrees.
+constexpr float kAngleMin = -1.396263f;
+constexpr std::size_t kBeams = 640;
+constexpr float kIncrement = 2.0f * 1.396263f / (kBeams - 1);
+
+wall_follower::BeamIndex sim_index()
+{
+  wall_follower::BeamIndex beams;
+  beams.update(kAngleMin, kIncrement, kBeams);
+  return beams;
+}
+
+}  // namespace
+
+TEST(BeamIndex, EdgesOfTheFieldOfView)
+{
+  const auto beams = sim_index();
+  EXPECT_EQ(beams.index(kAngleMin), 0u);
+  EXPECT_EQ(beams.index(-kAngleMin), kBeams - 1);
+}
+
+// The table resolves a quarter of a degree, so a lookup is within one beam
+// (0.25 degrees here) of the exact nearest one.
+TEST(BeamIndex, NearestBeamInside)
+{
+  const auto beams = sim_index();
+  for (std::size_t beam = 0; beam < kBeams; beam += 7) {
+    const float angle = kAngleMin + static_cast<float>(beam) * kIncrement;
+    const auto found = static_cast<long>(beams.index(angle));
+    EXPECT_LE(std::labs(found - static_cast<long>(beam)), 1) << "beam " << beam;
+  }
+}
+
+TEST(BeamIndex, OutOfRangeAnglesClampToTheFieldOfView)
+{
+  const auto beams = sim_index();
+  EXPECT_EQ(beams.index(-2.0f), 0u);
+  EXPECT_EQ(beams.index(2.0f), kBeams - 1);
+  // past +/-pi the table itself is clamped
+  EXPECT_EQ(beams.index(-10.0f), 0u);
+  EXPECT_EQ(beams.index(10.0f), kBeams - 1);
+  EXPECT_EQ(beams.index(-kPi), 0u);
+  EXPECT_EQ(beams.index(kPi), kBeams - 1);
+}
+
+TEST(BeamIndex, SpanIsOrderedWhicheverWayTheSensorSweeps)
+{
+  wall_follower::BeamIndex clockwise;
+  clockwise.update(-kAngleMin, -kIncrement, kBeams);
+  const auto span = clockwise.span(wall_follower::SectorAngles{-0.1f, 0.1f});
+  EXPECT_LT(span.begin, span.end);
+  EXPECT_EQ(clockwise.index(-kAngleMin), 0u);
+  EXPECT_EQ(clockwise.index(kAngleMin), kBeams - 1);
+
+  const auto beams = sim_index();
+  const auto forward = beams.span(wall_follower::SectorAngles{-0.1f, 0.1f});
+  const auto backward = beams.span(wall_follower::SectorAngles{0.1f, -0.1f});
+  EXPECT_EQ(forward.begin, backward.begin);
+  EXPECT_EQ(forward.end, backward.end);
+  EXPECT_EQ(forward.end - forward.begin, span.end - span.begin);
+}
+
+TEST(BeamIndex, RebuildsOnlyWhenTheMetadataChanges)
+{
+  wall_follower::BeamIndex beams;
+  EXPECT_TRUE(beams.update(kAngleMin, kIncrement, kBeams));
+  EXPECT_FALSE(beams.update(kAngleMin, kIncrement, kBeams));
+  EXPECT_TRUE(beams.update(kAngleMin, kIncrement, kBeams / 2));
+  EXPECT_EQ(beams.index(-kAngleMin), kBeams / 2 - 1);
+}
+
+TEST(BeamIndex, EmptyScanHasNoBeams)
+{
+  wall_follower::BeamIndex beams;
+  EXPECT_EQ(beams.index(0.0f), 0u);
+  beams.update(kAngleMin, kIncrement, 0);
+  const auto span = beams.span(wall_follower::SectorAngles{-0.1f, 0.1f});
+  EXPECT_EQ(span.begin, span.end);
+  beams.update(kAngleMin, 0.0f, kBeams);
+  EXPECT_EQ(beams.index(0.0f), 0u);
+}
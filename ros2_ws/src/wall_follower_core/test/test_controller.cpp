@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include "wall_follower_core/controller.hpp"
+
+namespace
+{
+
+using wall_follower::State;
+
+constexpr float kOpen = std::numeric_limits<float>::infinity();
+
+// A scan that fires each edge of kEdges, one with the same source state that
+// does not, and whether the edge counts a turn; in table order.
+struct EdgeCase
+{
+  wall_follower::ScanSummary fires;
+  wall_follower::ScanSummary stays;
+  bool counts_turn;
+};
+
+constexpr std::array<EdgeCase, 5> kCases{{
+  {{0.5f, kOpen, 0.0}, {5.0f, kOpen, 0.0}, false},    // approach->turn_right
+  {{kOpen, 3.0f, 0.0}, {5.0f, 3.0f, 0.0}, false},     // turn_right->move_along
+  {{kOpen, kOpen, 0.0}, {kOpen, 2.5f, 0.0}, false},   // move_along->turn_left_wall
+  {{kOpen, 1.0f, 0.0}, {kOpen, 2.5f, 0.0}, false},    // move_along->turn_right
+  {{kOpen, 1.5f, 0.0}, {kOpen, 5.0f, 0.0}, true},     // turn_left_wall->move_along
+}};
+static_assert(kCases.size() == wall_follower::kEdgeCount, "a case for every edge");
+
+// One step at `now`, the scan stamped with it.
+wall_follower::StepResult step_at(
+  const wall_follower::ControllerState & state, wall_follower::ScanSummary scan, double now,
+  wall_follower::TransitionStats * stats = nullptr)
+{
+  scan.stamp = now;
+  return wall_follower::step(state, scan, now, wall_follower::Config(), stats);
+}
+
+}  // namespace
+
+TEST(Controller, EveryEdgeFiresOnItsGuard)
+{
+  const wall_follower::Config config;
+  for (std::size_t e = 0; e < wall_follower::kEdgeCount; ++e) {
+    const auto & edge = wall_follower::kEdges[e];
+    const auto & c = kCases[e];
+    SCOPED_TRACE(edge.name);
+    wall_follower::TransitionStats stats;
+    wall_follower::ControllerState state;
+    state.state = edge.from;
+
+    double taken_at = 1.0;
+    auto result = step_at(state, c.fires, taken_at, &stats);
+    if (edge.hold != nullptr) {
+      // armed, still in the source state until the hold runs out
+      EXPECT_EQ(result.state.state, edge.from);
+      EXPECT_TRUE(result.state.hold.armed());
+      EXPECT_EQ(result.state.hold.target(), static_cast<int>(e));
+      taken_at += (config.*edge.hold).seconds;
+      result = step_at(result.state, c.fires, taken_at, &stats);
+    }
+    EXPECT_EQ(result.state.state, edge.to);
+    EXPECT_FALSE(result.state.hold.armed());
+    EXPECT_EQ(result.state.turns, c.counts_turn ? 1u : 0u);
+    // every edge stops the robot for the step it is taken on
+    EXPECT_EQ(result.command.linear_x, 0.0);
+    EXPECT_EQ(result.command.angular_z, 0.0);
+    for (std::size_t other = 0; other < wall_follower::kEdgeCount; ++other) {
+      EXPECT_EQ(stats.edge_count(other), other == e ? 1u : 0u);
+    }
+    EXPECT_EQ(stats.entry_time(edge.to), taken_at);
+  }
+}
+
+TEST(Controller, NoEdgeFiresWithoutItsGuard)
+{
+  const wall_follower::Config config;
+  for (std::size_t e = 0; e < wall_follower::kEdgeCount; ++e) {
+    const auto & edge = wall_follower::kEdges[e];
+    SCOPED_TRACE(edge.name);
+    wall_follower::ControllerState state;
+    state.state = edge.from;
+    const auto result = step_at(state, kCases[e].stays, 1.0);
+    EXPECT_EQ(result.state.state, edge.from);
+    EXPECT_FALSE(result.state.hold.armed());
+    const auto output = wall_follower::kOutputs[static_cast<std::size_t>(edge.from)](config);
+    EXPECT_EQ(result.command.linear_x, output.linear_x);
+    EXPECT_EQ(result.command.angular_z, output.angular_z);
+  }
+}
+
+// While the corner hold is armed, the state's other edges are suspended.
+TEST(Controller, ArmedHoldSuspendsTheOtherEdges)
+{
+  wall_follower::ControllerState state;
+  state.state = State::MOVE_ALONG;
+  auto result = step_at(state, {kOpen, kOpen, 0.0}, 1.0);
+  ASSERT_TRUE(result.state.hold.armed());
+  result = step_at(result.state, {kOpen, 1.0f, 0.0}, 1.01);
+  EXPECT_EQ(result.state.state, State::MOVE_ALONG);
+  EXPECT_TRUE(result.state.hold.armed());
+}
+
+TEST(Controller, EndedAndTouchedWallHaveNoWayOut)
+{
+  const std::array<wall_follower::ScanSummary, 3> scans{{
+    {0.5f, kOpen, 0.0}, {kOpen, 1.5f, 0.0}, {kOpen, kOpen, 0.0}}};
+  for (const State terminal : {State::ENDED, State::TOUCHED_WALL}) {
+    wall_follower::ControllerState state;
+    state.state = terminal;
+    for (const auto & scan : scans) {
+      const auto result = step_at(state, scan, 1.0);
+      EXPECT_EQ(result.state.state, terminal);
+      EXPECT_EQ(result.command.linear_x, 0.0);
+      EXPECT_EQ(result.command.angular_z, 0.0);
+    }
+  }
+}
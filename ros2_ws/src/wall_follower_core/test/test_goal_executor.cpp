@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "wall_follower_core/goal_executor.hpp"
+
+namespace
+{
+
+// A running goal that keeps its worker until it is told to stop, the way the
+// action server's goals do.
+struct Stoppable
+{
+  std::mutex mutex;
+  std::condition_variable changed;
+  bool started = false;
+  bool stop = false;
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    started = true;
+    changed.notify_all();
+    changed.wait(lock, [this]() {return stop;});
+  }
+
+  void wait_started()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() {return started;});
+  }
+
+  void preempt()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stop = true;
+    changed.notify_all();
+  }
+};
+
+}  // namespace
+
+// goal_queue=0 with the preempt policy: the new goal must take over the only
+// worker once the preempted goal returns, not be refused because that goal
+// was still running when it arrived.
+TEST(GoalExecutor, PreemptingGoalWaitsForPreemptedWorkerWithoutQueue)
+{
+  wall_follower::GoalExecutor executor(1, 0);
+  Stoppable running;
+  ASSERT_TRUE(executor.submit([&running]() {running.run();}));
+  running.wait_started();
+  EXPECT_TRUE(executor.full());
+
+  std::atomic<bool> took_over{false};
+  running.preempt();
+  ASSERT_TRUE(executor.submit_preempting([&took_over]() {took_over = true;}));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!took_over && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(took_over);
+}
+
+TEST(GoalExecutor, SubmitRespectsQueueBound)
+{
+  wall_follower::GoalExecutor executor(1, 0);
+  Stoppable running;
+  ASSERT_TRUE(executor.submit([&running]() {running.run();}));
+  running.wait_started();
+  EXPECT_FALSE(executor.submit([]() {}));
+  running.preempt();
+}
+
+TEST(GoalExecutor, SubmitPreemptingRefusedAfterShutdown)
+{
+  wall_follower::GoalExecutor executor(1, 0);
+  executor.shutdown();
+  EXPECT_FALSE(executor.submit_preempting([]() {}));
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <limits>
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/goal_runs.hpp"
+
+namespace
+{
+
+constexpr float kOpen = std::numeric_limits<float>::infinity();
+
+// What the action server's control step does with one scan.
+struct ControlStep
+{
+  wall_follower::ControllerState controller;
+  wall_follower::GoalRuns runs;
+  bool end_requested = false;
+  double now = 0.0;
+
+  void operator()(float front, float left)
+  {
+    if (end_requested) {
+      end_requested = false;
+      runs.end(controller);
+    }
+    runs.resume(controller);
+    now += 0.1;
+    controller = wall_follower::step(
+      controller, wall_follower::ScanSummary{front, left, now}, now).state;
+  }
+
+  void finish_goal()
+  {
+    if (runs.finish()) {
+      end_requested = true;
+    }
+  }
+
+  // Past the end of the wall, around the corner and back onto it.
+  void go_round_corner()
+  {
+    for (int i = 0; i < 5; ++i) {
+      (*this)(kOpen, kOpen);
+    }
+    (*this)(kOpen, 1.5f);
+  }
+};
+
+}  // namespace
+
+// A goal that succeeds ends the run; ENDED has no way out on its own, so the
+// next goal must resume it or it would wait for turns forever.
+TEST(GoalRuns, SecondGoalBackToBackMakesProgress)
+{
+  ControlStep step;
+  step.controller.state = wall_follower::State::MOVE_ALONG;
+
+  step.runs.start();
+  step.go_round_corner();
+  EXPECT_EQ(step.controller.turns, 1u);
+  step.finish_goal();
+  step(kOpen, kOpen);
+  EXPECT_EQ(step.controller.state, wall_follower::State::ENDED);
+  step.go_round_corner();
+  EXPECT_EQ(step.controller.turns, 1u);
+
+  step.runs.start();
+  step(kOpen, 2.5f);
+  EXPECT_EQ(step.controller.state, wall_follower::State::MOVE_ALONG);
+  step.go_round_corner();
+  EXPECT_EQ(step.controller.turns, 2u);
+  step.finish_goal();
+  step(kOpen, kOpen);
+  EXPECT_EQ(step.controller.state, wall_follower::State::ENDED);
+}
+
+TEST(GoalRuns, RunEndsOnlyWithTheLastGoal)
+{
+  ControlStep step;
+  step.controller.state = wall_follower::State::MOVE_ALONG;
+  step.runs.start();
+  step.runs.start();
+  step.finish_goal();
+  EXPECT_FALSE(step.end_requested);
+  step(kOpen, 2.5f);
+  EXPECT_EQ(step.controller.state, wall_follower::State::MOVE_ALONG);
+  step.finish_goal();
+  EXPECT_TRUE(step.end_requested);
+}
+
+// The next goal starts before the control step has applied the end.
+TEST(GoalRuns, GoalStartingAsAnotherEndsKeepsTheRobotMoving)
+{
+  ControlStep step;
+  step.controller.state = wall_follower::State::MOVE_ALONG;
+  step.runs.start();
+  step.finish_goal();
+  step.runs.start();
+  step(kOpen, 2.5f);
+  EXPECT_EQ(step.controller.state, wall_follower::State::MOVE_ALONG);
+}
+
+TEST(GoalRuns, TouchedWallIsNotResumed)
+{
+  ControlStep step;
+  step.controller.state = wall_follower::State::TOUCHED_WALL;
+  step.runs.start();
+  step(kOpen, 2.5f);
+  EXPECT_EQ(step.controller.state, wall_follower::State::TOUCHED_WALL);
+}
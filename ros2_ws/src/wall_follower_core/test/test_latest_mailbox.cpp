@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "wall_follower_core/latest_mailbox.hpp"
+
+TEST(LatestMailbox, EmptyUntilPosted)
+{
+  wall_follower::LatestMailbox<int> mailbox;
+  int value = -1;
+  EXPECT_FALSE(mailbox.take(value));
+  EXPECT_FALSE(mailbox.post(3));
+  EXPECT_TRUE(mailbox.take(value));
+  EXPECT_EQ(value, 3);
+  // taken once only
+  EXPECT_FALSE(mailbox.take(value));
+  EXPECT_EQ(mailbox.dropped(), 0u);
+}
+
+TEST(LatestMailbox, KeepsOnlyTheNewest)
+{
+  wall_follower::LatestMailbox<int> mailbox;
+  EXPECT_FALSE(mailbox.post(1));
+  EXPECT_TRUE(mailbox.post(2));
+  EXPECT_TRUE(mailbox.post(3));
+  int value = 0;
+  EXPECT_TRUE(mailbox.take(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_EQ(mailbox.dropped(), 2u);
+  EXPECT_FALSE(mailbox.post(4));
+  EXPECT_TRUE(mailbox.take(value));
+  EXPECT_EQ(value, 4);
+}
+
+// The scan callbacks post shared_ptrs; the consumer gets the posted object.
+TEST(LatestMailbox, MovesSharedPointersThrough)
+{
+  wall_follower::LatestMailbox<std::shared_ptr<const int>> mailbox;
+  const auto posted = std::make_shared<const int>(9);
+  mailbox.post(posted);
+  std::shared_ptr<const int> taken;
+  ASSERT_TRUE(mailbox.take(taken));
+  EXPECT_EQ(taken, posted);
+}
+
+// One producer, one consumer: values arrive in order, never twice, and every
+// posted value is either taken or counted as dropped.
+TEST(LatestMailbox, ConcurrentValuesAreTakenOrDropped)
+{
+  constexpr std::uint64_t kPosts = 200000;
+  wall_follower::LatestMailbox<std::uint64_t> mailbox;
+  std::uint64_t taken = 0;
+  std::uint64_t out_of_order = 0;
+  std::thread consumer([&]() {
+      std::uint64_t last = 0;
+      std::uint64_t value = 0;
+      while (last < kPosts) {
+        if (mailbox.take(value)) {
+          if (value <= last) {
+            out_of_order++;
+          }
+          last = value;
+          taken++;
+        }
+      }
+    });
+  for (std::uint64_t n = 1; n <= kPosts; ++n) {
+    mailbox.post(n);
+  }
+  consumer.join();
+  EXPECT_EQ(out_of_order, 0u);
+  EXPECT_EQ(taken + mailbox.dropped(), kPosts);
+}
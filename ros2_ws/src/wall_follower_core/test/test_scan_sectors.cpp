@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+#include "wall_follower_core/scan_sectors.hpp"
+
+namespace
+{
+
+constexpr float kInf = std::numeric_limits<float>::infinity();
+constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+constexpr float kRangeMin = 0.12f;
+constexpr float kRangeMax = 3.5f;
+
+// Valid returns mixed with NaN, +/-inf and returns outside [range_min, range_max].
+std::vector<float> noisy_scan(std::size_t size, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> range(kRangeMin, kRangeMax);
+  std::uniform_int_distribution<int> kind(0, 9);
+  std::vector<float> ranges(size);
+  for (auto & r : ranges) {
+    switch (kind(rng)) {
+      case 0: r = kNaN; break;
+      case 1: r = kInf; break;
+      case 2: r = -kInf; break;
+      case 3: r = 0.0f; break;
+      case 4: r = kRangeMax + 1.0f; break;
+      default: r = range(rng); break;
+    }
+  }
+  return ranges;
+}
+
+}  // namespace
+
+// Every start offset against the vector width and every tail length, so the
+// unaligned loads and the scalar remainder are both covered.
+TEST(ScanSectors, SimdMatchesScalarForUnalignedSpans)
+{
+  const auto ranges = noisy_scan(96, 7);
+  for (std::size_t begin = 0; begin < 9; ++begin) {
+    for (std::size_t end = begin; end <= ranges.size(); ++end) {
+      const auto simd = wall_follower::detail::reduce_span_simd(
+        ranges.data(), begin, end, kRangeMin, kRangeMax);
+      const auto scalar = wall_follower::detail::reduce_span_scalar(
+        ranges.data(), begin, end, kRangeMin, kRangeMax);
+      ASSERT_EQ(simd.valid, scalar.valid) << "[" << begin << ", " << end << ")";
+      ASSERT_EQ(simd.min, scalar.min) << "[" << begin << ", " << end << ")";
+      if (scalar.valid == 0) {
+        ASSERT_EQ(simd.mean, kInf);
+      } else {
+        // lanes sum in a different order
+        ASSERT_NEAR(simd.mean, scalar.mean, 1e-5f * scalar.mean);
+      }
+    }
+  }
+}
+
+TEST(ScanSectors, InvalidReturnsAreSkipped)
+{
+  const std::vector<float> ranges{kNaN, 1.0f, kInf, -kInf, 0.05f, 2.0f, 4.0f, kNaN, 3.0f};
+  const wall_follower::SectorSpan span{0, ranges.size()};
+  wall_follower::SectorSummary summary;
+  wall_follower::reduce_sectors(
+    ranges.data(), ranges.size(), kRangeMin, kRangeMax, &span, 1, &summary);
+  EXPECT_EQ(summary.valid, 3u);
+  EXPECT_EQ(summary.min, 1.0f);
+  EXPECT_FLOAT_EQ(summary.mean, 2.0f);
+}
+
+TEST(ScanSectors, SectorWithoutValidReturnsReadsAsOpen)
+{
+  const std::vector<float> ranges(11, kNaN);
+  const wall_follower::SectorSpan span{0, ranges.size()};
+  wall_follower::SectorSummary summary;
+  wall_follower::reduce_sectors(
+    ranges.data(), ranges.size(), kRangeMin, kRangeMax, &span, 1, &summary);
+  EXPECT_EQ(summary.valid, 0u);
+  EXPECT_EQ(summary.min, kInf);
+  EXPECT_EQ(summary.mean, kInf);
+}
+
+TEST(ScanSectors, SpansAreClampedToTheScan)
+{
+  const std::vector<float> ranges{1.0f, 2.0f, 3.0f};
+  const wall_follower::SectorSpan spans[] = {{1, 40}, {5, 9}, {2, 1}};
+  wall_follower::SectorSummary out[3];
+  wall_follower::reduce_sectors(ranges.data(), ranges.size(), kRangeMin, kRangeMax, spans, 3, out);
+  EXPECT_EQ(out[0].valid, 2u);
+  EXPECT_EQ(out[0].min, 2.0f);
+  EXPECT_EQ(out[1].valid, 0u);
+  EXPECT_EQ(out[2].valid, 0u);
+}
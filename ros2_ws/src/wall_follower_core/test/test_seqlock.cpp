@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/seqlock.hpp"
+
+namespace
+{
+
+// Every field derives from steps, so a read that mixes two writes shows.
+void publish_step(wall_follower::ControllerSnapshot & s, std::uint64_t n)
+{
+  s.steps = n;
+  s.turns = static_cast<std::uint32_t>(n);
+  s.circles = static_cast<std::uint32_t>(n / 2);
+  s.state = static_cast<wall_follower::State>(n % 4);
+  s.scan.front = static_cast<float>(n % 1000);
+  s.scan.left = -static_cast<float>(n % 1000);
+  s.scan.stamp = static_cast<double>(n);
+}
+
+bool consistent(const wall_follower::ControllerSnapshot & s)
+{
+  wall_follower::ControllerSnapshot expected = s;
+  publish_step(expected, s.steps);
+  return s.turns == expected.turns && s.circles == expected.circles &&
+         s.state == expected.state && s.scan.front == expected.scan.front &&
+         s.scan.left == expected.scan.left && s.scan.stamp == expected.scan.stamp;
+}
+
+}  // namespace
+
+TEST(Seqlock, LoadsWhatWasStored)
+{
+  wall_follower::Seqlock<wall_follower::ControllerSnapshot> snapshot;
+  EXPECT_EQ(snapshot.load().steps, 0u);
+  EXPECT_EQ(snapshot.version(), 0u);
+  wall_follower::ControllerSnapshot s;
+  publish_step(s, 7);
+  snapshot.store(s);
+  EXPECT_EQ(snapshot.load().steps, 7u);
+  EXPECT_TRUE(consistent(snapshot.load()));
+  EXPECT_EQ(snapshot.version(), 1u);
+}
+
+TEST(Seqlock, UpdateKeepsTheOtherFields)
+{
+  wall_follower::ControllerSnapshot s;
+  publish_step(s, 41);
+  wall_follower::Seqlock<wall_follower::ControllerSnapshot> snapshot(s);
+  snapshot.update([](wall_follower::ControllerSnapshot & current) {current.touched = true;});
+  const auto loaded = snapshot.load();
+  EXPECT_TRUE(loaded.touched);
+  EXPECT_EQ(loaded.steps, 41u);
+  EXPECT_TRUE(consistent(loaded));
+}
+
+// The server's pattern, bounded by a write count rather than time: a control
+// thread publishing steps, a contact thread flipping one field and readers.
+TEST(Seqlock, ReadersNeverSeeATornOrOlderSnapshot)
+{
+  constexpr std::uint64_t kWrites = 200000;
+  wall_follower::Seqlock<wall_follower::ControllerSnapshot> snapshot;
+  std::atomic<bool> running{true};
+  std::atomic<std::uint64_t> torn{0};
+  std::atomic<std::uint64_t> reads{0};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back(
+      [&]() {
+        std::uint64_t last_steps = 0;
+        while (running.load(std::memory_order_relaxed)) {
+          const auto s = snapshot.load();
+          if (!consistent(s) || s.steps < last_steps) {
+            torn.fetch_add(1, std::memory_order_relaxed);
+          }
+          last_steps = s.steps;
+          reads.fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+  }
+  threads.emplace_back(
+    [&]() {
+      while (running.load(std::memory_order_relaxed)) {
+        snapshot.update([](wall_follower::ControllerSnapshot & s) {s.touched = !s.touched;});
+        std::this_thread::yield();
+      }
+    });
+
+  for (std::uint64_t n = 1; n <= kWrites; ++n) {
+    snapshot.update([n](wall_follower::ControllerSnapshot & s) {publish_step(s, n);});
+  }
+  running = false;
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(torn.load(), 0u);
+  EXPECT_GT(reads.load(), 0u);
+  EXPECT_EQ(snapshot.load().steps, kWrites);
+}
+
+// Writers serialise on the sequence: no read-modify-write is lost.
+TEST(Seqlock, ConcurrentUpdatesAreNotLost)
+{
+  constexpr std::uint64_t kPerWriter = 50000;
+  wall_follower::Seqlock<wall_follower::ControllerSnapshot> snapshot;
+  std::vector<std::thread> writers;
+  for (int i = 0; i < 3; ++i) {
+    writers.emplace_back(
+      [&]() {
+        for (std::uint64_t n = 0; n < kPerWriter; ++n) {
+          snapshot.update([](wall_follower::ControllerSnapshot & s) {s.steps++;});
+        }
+      });
+  }
+  for (auto & writer : writers) {
+    writer.join();
+  }
+  EXPECT_EQ(snapshot.load().steps, 3 * kPerWriter);
+  EXPECT_EQ(snapshot.version(), 3 * kPerWriter);
+}
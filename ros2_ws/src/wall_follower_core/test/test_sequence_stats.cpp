@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include "wall_follower_core/sequence_stats.hpp"
+
+namespace
+{
+
+void feed(wall_follower::SequenceStats & stats, std::initializer_list<std::int64_t> seqs)
+{
+  static std::int64_t now = 0;
+  for (const auto seq : seqs) {
+    now += 1000000;
+    stats.record(seq, now);
+  }
+}
+
+void feed_range(wall_follower::SequenceStats & stats, std::int64_t begin, std::int64_t end)
+{
+  for (std::int64_t seq = begin; seq < end; ++seq) {
+    feed(stats, {seq});
+  }
+}
+
+}  // namespace
+
+TEST(SequenceStats, CountsGapsReordersAndDuplicates)
+{
+  wall_follower::SequenceStats stats;
+  feed(stats, {0, 1, 2, 5, 3, 6, 6, 9});
+  EXPECT_EQ(stats.received(), 8u);
+  EXPECT_EQ(stats.gaps(), 2u);        // 3-4 and 7-8
+  EXPECT_EQ(stats.reordered(), 1u);   // 3
+  EXPECT_EQ(stats.lost(), 3u);        // 4, 7, 8
+  EXPECT_EQ(stats.duplicates(), 1u);  // the second 6
+  EXPECT_EQ(stats.restarts(), 0u);
+}
+
+// A publisher that restarts after fewer messages than the seen window must
+// not have its new numbers counted as duplicates of the old ones.
+TEST(SequenceStats, BackwardsJumpPastToleranceIsARestart)
+{
+  wall_follower::SequenceStats stats(16);
+  feed_range(stats, 0, 100);
+  feed_range(stats, 0, 100);
+  EXPECT_EQ(stats.restarts(), 1u);
+  EXPECT_EQ(stats.duplicates(), 0u);
+  EXPECT_EQ(stats.reordered(), 0u);
+  EXPECT_EQ(stats.lost(), 0u);
+}
+
+TEST(SequenceStats, BackwardsJumpWithinToleranceIsAReorder)
+{
+  wall_follower::SequenceStats stats(16);
+  feed_range(stats, 0, 100);
+  feed(stats, {120, 105});
+  EXPECT_EQ(stats.restarts(), 0u);
+  EXPECT_EQ(stats.reordered(), 1u);
+  EXPECT_EQ(stats.lost(), 19u);
+}
+
+TEST(SequenceStats, RejectsToleranceOutsideWindow)
+{
+  EXPECT_THROW(wall_follower::SequenceStats(-1), std::invalid_argument);
+  EXPECT_THROW(
+    wall_follower::SequenceStats(wall_follower::SequenceStats::kWindow), std::invalid_argument);
+}
@@ -0,0 +1,24 @@
+#ifndef WALL_SIM__DEFAULT_WORLD_HPP_
+#define WALL_SIM__DEFAULT_WORLD_HPP_
+
+#include <vector>
+
+namespace wall_sim
+{
+
+// A free-standing block, 1.5 m deep and 2 m wide, ahead of a robot that starts
+// at the origin facing +x, with open space beyond the 10 m lidar range all
+// around. Sized so the controller's default Config circles it:
+// closed_loop_bench fails when it no longer does.
+const std::vector<double> kDefaultWall{
+  5.0, -1.0,
+  6.5, -1.0,
+  6.5, 1.0,
+  5.0, 1.0,
+};
+
+constexpr double kRobotRadius = 0.3;
+
+}  // namespace wall_sim
+
+#endif  // WALL_SIM__DEFAULT_WORLD_HPP_
@@ -0,0 +1,206 @@
+#ifndef WALL_SIM__WORLD_HPP_
+#define WALL_SIM__WORLD_HPP_
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace wall_sim
+{
+
+struct Pose
+{
+  double x = 0.0;
+  double y = 0.0;
+  double theta = 0.0;
+};
+
+// Unicycle model: forward speed v along the heading, yaw rate w.
+inline Pose integrate(const Pose & pose, double v, double w, double dt)
+{
+  Pose next;
+  next.theta = pose.theta + w * dt;
+  const double heading = pose.theta + 0.5 * w * dt;
+  next.x = pose.x + v * std::cos(heading) * dt;
+  next.y = pose.y + v * std::sin(heading) * dt;
+  next.theta = std::atan2(std::sin(next.theta), std::cos(next.theta));
+  return next;
+}
+
+// Planar 2D lidar: beams evenly spread over [angle_min, angle_max].
+struct LidarModel
+{
+  std::size_t beams = 640;
+  float angle_min = -1.396263f;
+  float angle_max = 1.396263f;
+  float range_min = 0.12f;
+  float range_max = 10.0f;
+
+  float angle_increment() const
+  {
+    return beams > 1 ? (angle_max - angle_min) / static_cast<float>(beams - 1) : 0.0f;
+  }
+};
+
+// Line-segment world stored as structure of arrays, ray-cast several beams at
+// a time against each segment.
+class World
+{
+public:
+  void add_segment(float x0, float y0, float x1, float y1)
+  {
+    px_.push_back(x0);
+    py_.push_back(y0);
+    ex_.push_back(x1 - x0);
+    ey_.push_back(y1 - y0);
+  }
+
+  // Closed polygon from consecutive vertices (x0, y0, x1, y1, ...).
+  void add_polygon(const std::vector<double> & xy)
+  {
+    const std::size_t n = xy.size() / 2;
+    for (std::size_t i = 0; i < n; ++i) {
+      const std::size_t j = (i + 1) % n;
+      add_segment(
+        static_cast<float>(xy[2 * i]), static_cast<float>(xy[2 * i + 1]),
+        static_cast<float>(xy[2 * j]), static_cast<float>(xy[2 * j + 1]));
+    }
+  }
+
+  std::size_t segments() const
+  {
+    return px_.size();
+  }
+
+  // True when a disc of the given radius around (x, y) touches any segment.
+  bool collides(double x, double y, double radius) const
+  {
+    for (std::size_t i = 0; i < px_.size(); ++i) {
+      const double ex = ex_[i];
+      const double ey = ey_[i];
+      const double wx = x - px_[i];
+      const double wy = y - py_[i];
+      const double length2 = ex * ex + ey * ey;
+      double t = length2 > 0.0 ? (wx * ex + wy * ey) / length2 : 0.0;
+      t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+      const double dx = wx - t * ex;
+      const double dy = wy - t * ey;
+      if (dx * dx + dy * dy <= radius * radius) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Fills ranges (lidar.beams entries) for a sensor at pose. Beams that hit
+  // nothing within range_max read +inf, like the Gazebo gpu_lidar.
+  void raycast(const Pose & pose, const LidarModel & lidar, std::vector<float> & ranges)
+  {
+    prepare(pose, lidar);
+    ranges.assign(lidar.beams, std::numeric_limits<float>::infinity());
+    const float ox = static_cast<float>(pose.x);
+    const float oy = static_cast<float>(pose.y);
+    for (std::size_t s = 0; s < px_.size(); ++s) {
+      cast_segment(s, ox, oy, ranges);
+    }
+    for (auto & r : ranges) {
+      if (r > lidar.range_max) {
+        r = std::numeric_limits<float>::infinity();
+      } else if (r < lidar.range_min) {
+        r = lidar.range_min;
+      }
+    }
+  }
+
+private:
+  // World-frame beam directions for the current heading.
+  void prepare(const Pose & pose, const LidarModel & lidar)
+  {
+    if (beam_cos_.size() != lidar.beams || angle_min_ != lidar.angle_min ||
+      angle_increment_ != lidar.angle_increment())
+    {
+      angle_min_ = lidar.angle_min;
+      angle_increment_ = lidar.angle_increment();
+      beam_cos_.resize(lidar.beams);
+      beam_sin_.resize(lidar.beams);
+      for (std::size_t b = 0; b < lidar.beams; ++b) {
+        const float a = angle_min_ + static_cast<float>(b) * angle_increment_;
+        beam_cos_[b] = std::cos(a);
+        beam_sin_[b] = std::sin(a);
+      }
+      dx_.resize(lidar.beams);
+      dy_.resize(lidar.beams);
+    }
+    const float c = static_cast<float>(std::cos(pose.theta));
+    const float s = static_cast<float>(std::sin(pose.theta));
+    for (std::size_t b = 0; b < lidar.beams; ++b) {
+      dx_[b] = c * beam_cos_[b] - s * beam_sin_[b];
+      dy_[b] = s * beam_cos_[b] + c * beam_sin_[b];
+    }
+  }
+
+  // Ray o + r*d meets segment p + t*e where r = cross(w, e) / cross(d, e) and
+  // t = cross(w, d) / cross(d, e), with w = p - o. Parallel rays divide by zero;
+  // the resulting inf/NaN fail the ordered range checks and are discarded.
+  void cast_segment(std::size_t s, float ox, float oy, std::vector<float> & ranges) const
+  {
+    const float ex = ex_[s];
+    const float ey = ey_[s];
+    const float wx = px_[s] - ox;
+    const float wy = py_[s] - oy;
+    const float w_cross_e = wx * ey - wy * ex;
+    const std::size_t n = ranges.size();
+    std::size_t b = 0;
+#if defined(__SSE2__)
+    const __m128 vex = _mm_set1_ps(ex);
+    const __m128 vey = _mm_set1_ps(ey);
+    const __m128 vwx = _mm_set1_ps(wx);
+    const __m128 vwy = _mm_set1_ps(wy);
+    const __m128 vwe = _mm_set1_ps(w_cross_e);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; b + 4 <= n; b += 4) {
+      const __m128 dx = _mm_loadu_ps(&dx_[b]);
+      const __m128 dy = _mm_loadu_ps(&dy_[b]);
+      const __m128 denom = _mm_sub_ps(_mm_mul_ps(dx, vey), _mm_mul_ps(dy, vex));
+      const __m128 r = _mm_div_ps(vwe, denom);
+      const __m128 t = _mm_div_ps(_mm_sub_ps(_mm_mul_ps(vwx, dy), _mm_mul_ps(vwy, dx)), denom);
+      const __m128 hit = _mm_and_ps(
+        _mm_and_ps(_mm_cmpge_ps(r, zero), _mm_cmpge_ps(t, zero)), _mm_cmple_ps(t, one));
+      const __m128 current = _mm_loadu_ps(&ranges[b]);
+      const __m128 nearer = _mm_and_ps(hit, _mm_cmplt_ps(r, current));
+      _mm_storeu_ps(
+        &ranges[b], _mm_or_ps(_mm_and_ps(nearer, r), _mm_andnot_ps(nearer, current)));
+    }
+#endif
+    for (; b < n; ++b) {
+      const float denom = dx_[b] * ey - dy_[b] * ex;
+      const float r = w_cross_e / denom;
+      const float t = (wx * dy_[b] - wy * dx_[b]) / denom;
+      if (r >= 0.0f && t >= 0.0f && t <= 1.0f && r < ranges[b]) {
+        ranges[b] = r;
+      }
+    }
+  }
+
+  std::vector<float> px_;
+  std::vector<float> py_;
+  std::vector<float> ex_;
+  std::vector<float> ey_;
+
+  float angle_min_ = 0.0f;
+  float angle_increment_ = 0.0f;
+  std::vector<float> beam_cos_;
+  std::vector<float> beam_sin_;
+  std::vector<float> dx_;
+  std::vector<float> dy_;
+};
+
+}  // namespace wall_sim
+
+#endif  // WALL_SIM__WORLD_HPP_
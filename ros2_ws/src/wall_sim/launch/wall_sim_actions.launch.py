@@ -0,0 +1,30 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+from launch_ros.parameter_descriptions import ParameterValue
+
+def generate_launch_description():
+    # typed so that real_time_factor:=20 is not read as an integer
+    real_time_factor = ParameterValue(LaunchConfiguration('real_time_factor'), value_type=float)
+    lockstep = ParameterValue(LaunchConfiguration('lockstep'), value_type=bool)
+    controller = {'use_sim_time': True}
+    return LaunchDescription([
+        DeclareLaunchArgument('real_time_factor', default_value='1.0'),
+        DeclareLaunchArgument('lockstep', default_value='false'),
+        Node(
+            package='wall_sim',
+            executable='wall_sim',
+            parameters=[{'real_time_factor': real_time_factor, 'lockstep': lockstep}],
+            output='screen'),
+        Node(
+            package='circle_wall_actions_pkg',
+            executable='circle_wall_server',
+            parameters=[controller],
+            output='screen'),
+        Node(
+            package='circle_wall_actions_pkg',
+            executable='circle_wall_client',
+            parameters=[{'use_sim_time': True}],
+            output='screen'),
+    ])
@@ -0,0 +1,45 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer, Node
+from launch_ros.descriptions import ComposableNode
+from launch_ros.parameter_descriptions import ParameterValue
+
+def generate_launch_description():
+    # typed so that real_time_factor:=20 is not read as an integer
+    real_time_factor = ParameterValue(LaunchConfiguration('real_time_factor'), value_type=float)
+    lockstep = ParameterValue(LaunchConfiguration('lockstep'), value_type=bool)
+    controller = {'use_sim_time': True}
+    intra_process = [{
+        'use_intra_process_comms':
+            ParameterValue(LaunchConfiguration('intra_process'), value_type=bool)}]
+    return LaunchDescription([
+        DeclareLaunchArgument('real_time_factor', default_value='1.0'),
+        DeclareLaunchArgument('lockstep', default_value='false'),
+        DeclareLaunchArgument('intra_process', default_value='true'),
+        # multi-threaded container so the server's callback groups run in parallel
+        ComposableNodeContainer(
+            name='wall_sim_container',
+            namespace='',
+            package='rclcpp_components',
+            executable='component_container_mt',
+            composable_node_descriptions=[
+                ComposableNode(
+                    package='wall_sim',
+                    plugin='WallSim',
+                    parameters=[{'real_time_factor': real_time_factor, 'lockstep': lockstep}],
+                    extra_arguments=intra_process),
+                ComposableNode(
+                    package='circle_wall_actions_pkg',
+                    plugin='CircleWallActionServer',
+                    parameters=[controller],
+                    extra_arguments=intra_process),
+            ],
+            output='screen'),
+        # the client sends one goal and exits, so it runs as its own process
+        Node(
+            package='circle_wall_actions_pkg',
+            executable='circle_wall_client',
+            parameters=[{'use_sim_time': True}],
+            output='screen'),
+    ])
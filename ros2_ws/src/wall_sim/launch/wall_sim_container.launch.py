@@ -0,0 +1,40 @@
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+from launch_ros.parameter_descriptions import ParameterValue
+
+def generate_launch_description():
+    # typed so that real_time_factor:=20 is not read as an integer
+    real_time_factor = ParameterValue(LaunchConfiguration('real_time_factor'), value_type=float)
+    lockstep = ParameterValue(LaunchConfiguration('lockstep'), value_type=bool)
+    controller = {'use_sim_time': True}
+    intra_process = [{
+        'use_intra_process_comms':
+            ParameterValue(LaunchConfiguration('intra_process'), value_type=bool)}]
+    return LaunchDescription([
+        DeclareLaunchArgument('real_time_factor', default_value='1.0'),
+        DeclareLaunchArgument('lockstep', default_value='false'),
+        DeclareLaunchArgument('intra_process', default_value='true'),
+        # sim and controller share one process: lidar and cmd_vel are handed
+        # over as pointers when intra_process is true
+        ComposableNodeContainer(
+            name='wall_sim_container',
+            namespace='',
+            package='rclcpp_components',
+            executable='component_container_mt',
+            composable_node_descriptions=[
+                ComposableNode(
+                    package='wall_sim',
+                    plugin='WallSim',
+                    parameters=[{'real_time_factor': real_time_factor, 'lockstep': lockstep}],
+                    extra_arguments=intra_process),
+                ComposableNode(
+                    package='topic_publisher_pkg',
+                    plugin='CircleWall',
+                    parameters=[controller],
+                    extra_arguments=intra_process),
+            ],
+            output='screen'),
+    ])
@@ -0,0 +1,80 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "wall_follower_core/controller.hpp"
+#include "wall_follower_core/scan_analyzer.hpp"
+#include "wall_sim/default_world.hpp"
+#include "wall_sim/world.hpp"
+
+// Runs the wall-following controller against the simulator with no ROS in the
+// loop and reports how much faster than real time the closed loop runs. Exits
+// non-zero when the robot touches the wall or makes fewer than min_turns
+// turns, so it doubles as a regression check of the controller's defaults
+// against the default world.
+//   closed_loop_bench [sim_seconds] [corner_hold_s] [min_turns]
+int main(int argc, char * argv[])
+{
+  const double sim_seconds = argc > 1 ? std::atof(argv[1]) : 600.0;
+  wall_follower::Config config;
+  if (argc > 2) {
+    config.corner_hold = wall_follower::HoldCondition{std::atof(argv[2]), 0.0};
+  }
+  const unsigned long min_turns = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+  const double physics_dt = 0.01;
+  const int steps_per_scan = 10;
+
+  wall_sim::World world;
+  world.add_polygon(wall_sim::kDefaultWall);
+  const wall_sim::LidarModel lidar;
+  wall_sim::Pose pose;
+  std::vector<float> ranges;
+
+  wall_follower::ScanAnalyzer analyzer;
+  wall_follower::ControllerState controller;
+  wall_follower::Command command;
+  bool touched = false;
+
+  double raycast_seconds = 0.0;
+  std::size_t scans = 0;
+  const auto start = std::chrono::steady_clock::now();
+  double now = 0.0;
+  while (now < sim_seconds && !touched) {
+    for (int i = 0; i < steps_per_scan; ++i) {
+      const auto next = wall_sim::integrate(pose, command.linear_x, command.angular_z, physics_dt);
+      if (world.collides(next.x, next.y, wall_sim::kRobotRadius)) {
+        touched = true;
+        break;
+      }
+      pose = next;
+      now += physics_dt;
+    }
+    const auto cast_start = std::chrono::steady_clock::now();
+    world.raycast(pose, lidar, ranges);
+    raycast_seconds += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - cast_start).count();
+    const auto scan = analyzer.analyze(
+      ranges.data(), ranges.size(), lidar.angle_min, lidar.angle_increment(),
+      lidar.range_min, lidar.range_max, now);
+    const auto result = wall_follower::step(controller, scan, now, config);
+    controller = result.state;
+    command = result.command;
+    scans++;
+  }
+  const double wall = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  std::printf(
+    "sim %.1f s in %.3f s wall (%.0fx real time), %zu scans, raycast %.2f us/scan\n",
+    now, wall, now / wall, scans, 1e6 * raycast_seconds / static_cast<double>(scans));
+  std::printf(
+    "turns=%u circles=%u state=%s touched=%s final pose (%.2f, %.2f, %.2f)\n",
+    controller.turns, controller.turns / 2, wall_follower::to_string(controller.state),
+    touched ? "yes" : "no", pose.x, pose.y, pose.theta);
+  if (touched || controller.turns < min_turns) {
+    std::fprintf(
+      stderr, "FAIL: expected at least %lu turns without touching the wall\n", min_turns);
+    return 1;
+  }
+  return 0;
+}
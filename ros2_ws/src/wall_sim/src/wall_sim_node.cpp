@@ -0,0 +1,213 @@
+#include "geometry_msgs/msg/twist.hpp"
+#include "rclcpp/rclcpp.hpp"
+#include "rclcpp_components/register_node_macro.hpp"
+#include "rosgraph_msgs/msg/clock.hpp"
+#include "sensor_msgs/msg/laser_scan.hpp"
+#include "std_msgs/msg/bool.hpp"
+#include "wall_sim/default_world.hpp"
+#include "wall_sim/world.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::placeholders::_1;
+
+// Headless stand-in for the Ignition world and its bridges: integrates a
+// unicycle from cmd_vel, publishes a 640-beam lidar scan, wall/touched and
+// /clock. Run the controllers with use_sim_time so they follow the sim clock.
+class WallSim : public rclcpp::Node
+{
+public:
+  explicit WallSim(const rclcpp::NodeOptions & options = rclcpp::NodeOptions())
+  : Node("wall_sim", options)
+  {
+    const auto walls = this->declare_parameter("walls", wall_sim::kDefaultWall);
+    physics_dt_ = this->declare_parameter("physics_dt", 0.01);
+    steps_per_scan_ = this->declare_parameter<int>("steps_per_scan", 10);
+    // 1.0 follows the wall clock, 0 runs as fast as the CPU allows
+    real_time_factor_ = this->declare_parameter("real_time_factor", 1.0);
+    // lockstep: after each scan, hold the clock until a cmd_vel answers it (or
+    // lockstep_timeout_ms of wall time passes), so fast runs stay deterministic
+    lockstep_ = this->declare_parameter("lockstep", false);
+    lockstep_timeout_ = std::chrono::milliseconds(
+      this->declare_parameter<int64_t>("lockstep_timeout_ms", 100));
+    robot_radius_ = this->declare_parameter("robot_radius", wall_sim::kRobotRadius);
+    pose_.x = this->declare_parameter("start_x", 0.0);
+    pose_.y = this->declare_parameter("start_y", 0.0);
+    pose_.theta = this->declare_parameter("start_theta", 0.0);
+    lidar_.beams = static_cast<std::size_t>(this->declare_parameter<int>("beams", 640));
+    lidar_.range_max = static_cast<float>(this->declare_parameter("range_max", 10.0));
+    frame_id_ = this->declare_parameter("frame_id", std::string("lidar_link"));
+
+    if (walls.size() < 4 || walls.size() % 2 != 0) {
+      throw std::invalid_argument("walls must hold at least two x, y vertex pairs");
+    }
+    if (physics_dt_ <= 0.0 || steps_per_scan_ < 1 || lidar_.beams < 2) {
+      throw std::invalid_argument("physics_dt, steps_per_scan and beams must be positive");
+    }
+    world_.add_polygon(walls);
+
+    scan_.header.frame_id = frame_id_;
+    scan_.angle_min = lidar_.angle_min;
+    scan_.angle_max = lidar_.angle_max;
+    scan_.angle_increment = lidar_.angle_increment();
+    scan_.scan_time = static_cast<float>(physics_dt_ * steps_per_scan_);
+    scan_.range_min = lidar_.range_min;
+    scan_.range_max = lidar_.range_max;
+
+    clock_publisher_ = this->create_publisher<rosgraph_msgs::msg::Clock>(
+      "/clock", rclcpp::ClockQoS());
+    scan_publisher_ = this->create_publisher<sensor_msgs::msg::LaserScan>(
+      "lidar", rclcpp::SensorDataQoS());
+    touched_publisher_ = this->create_publisher<std_msgs::msg::Bool>("wall/touched", 10);
+    cmd_subscription_ = this->create_subscription<geometry_msgs::msg::Twist>(
+      "cmd_vel", 10, std::bind(&WallSim::cmd_callback, this, _1));
+
+    RCLCPP_INFO(
+      this->get_logger(), "Simulating %zu wall segments, dt=%.3f s, real time factor %.1f%s",
+      world_.segments(), physics_dt_, real_time_factor_, lockstep_ ? ", lockstep" : "");
+    running_ = true;
+    sim_thread_ = std::thread(&WallSim::run, this);
+  }
+
+  ~WallSim()
+  {
+    {
+      std::lock_guard<std::mutex> lock(cmd_mutex_);
+      running_ = false;
+    }
+    cmd_cv_.notify_all();
+    if (sim_thread_.joinable()) {
+      sim_thread_.join();
+    }
+    RCLCPP_INFO(
+      this->get_logger(),
+      "Simulated %.1f s, %lu contacts, %lu lockstep timeouts, final pose (%.2f, %.2f, %.2f)",
+      static_cast<double>(sim_ns_) * 1e-9, contacts_, lockstep_timeouts_,
+      pose_.x, pose_.y, pose_.theta);
+  }
+
+private:
+  void cmd_callback(const geometry_msgs::msg::Twist::SharedPtr msg)
+  {
+    linear_x_.store(msg->linear.x, std::memory_order_relaxed);
+    angular_z_.store(msg->angular.z, std::memory_order_relaxed);
+    if (lockstep_) {
+      {
+        std::lock_guard<std::mutex> lock(cmd_mutex_);
+        cmd_count_++;
+      }
+      cmd_cv_.notify_one();
+    }
+  }
+
+  void run()
+  {
+    const auto dt_ns = static_cast<int64_t>(std::llround(physics_dt_ * 1e9));
+    const auto start = std::chrono::steady_clock::now();
+    rosgraph_msgs::msg::Clock clock;
+    std_msgs::msg::Bool touched;
+    touched.data = true;
+    publish_scan();
+    wait_for_command();
+    while (running_.load() && rclcpp::ok()) {
+      bool contact = false;
+      for (int i = 0; i < steps_per_scan_; ++i) {
+        const auto next = wall_sim::integrate(
+          pose_, linear_x_.load(std::memory_order_relaxed),
+          angular_z_.load(std::memory_order_relaxed), physics_dt_);
+        // the robot stops at the wall instead of passing through it
+        if (world_.collides(next.x, next.y, robot_radius_)) {
+          contact = true;
+        } else {
+          pose_ = next;
+        }
+        sim_ns_ += dt_ns;
+        clock.clock = rclcpp::Time(sim_ns_, RCL_ROS_TIME);
+        clock_publisher_->publish(clock);
+      }
+      if (contact) {
+        contacts_++;
+        touched_publisher_->publish(touched);
+      }
+      publish_scan();
+      wait_for_command();
+      if (real_time_factor_ > 0.0) {
+        std::this_thread::sleep_until(
+          start + std::chrono::nanoseconds(
+            static_cast<int64_t>(static_cast<double>(sim_ns_) / real_time_factor_)));
+      }
+    }
+  }
+
+  void publish_scan()
+  {
+    if (lockstep_) {
+      std::lock_guard<std::mutex> lock(cmd_mutex_);
+      answered_count_ = cmd_count_;
+    }
+    scan_.header.stamp = rclcpp::Time(sim_ns_, RCL_ROS_TIME);
+    if (intra_process_) {
+      // a fresh message handed over whole, so a controller in this process
+      // takes it without a copy; scan_ keeps only the fixed fields
+      auto scan = std::make_unique<sensor_msgs::msg::LaserScan>(scan_);
+      world_.raycast(pose_, lidar_, scan->ranges);
+      scan_publisher_->publish(std::move(scan));
+    } else {
+      world_.raycast(pose_, lidar_, scan_.ranges);
+      scan_publisher_->publish(scan_);
+    }
+  }
+
+  void wait_for_command()
+  {
+    if (!lockstep_) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(cmd_mutex_);
+    if (!cmd_cv_.wait_for(
+        lock, lockstep_timeout_,
+        [this]() {return cmd_count_ != answered_count_ || !running_.load();}))
+    {
+      lockstep_timeouts_++;
+    }
+  }
+
+  wall_sim::World world_;
+  wall_sim::LidarModel lidar_;
+  wall_sim::Pose pose_;
+  double physics_dt_ = 0.01;
+  int steps_per_scan_ = 10;
+  double real_time_factor_ = 1.0;
+  double robot_radius_ = wall_sim::kRobotRadius;
+  bool lockstep_ = false;
+  std::chrono::milliseconds lockstep_timeout_{100};
+  std::string frame_id_;
+
+  std::atomic<double> linear_x_{0.0};
+  std::atomic<double> angular_z_{0.0};
+  std::atomic<bool> running_{false};
+  std::mutex cmd_mutex_;
+  std::condition_variable cmd_cv_;
+  uint64_t cmd_count_ = 0;
+  uint64_t answered_count_ = 0;
+  uint64_t lockstep_timeouts_ = 0;
+  std::thread sim_thread_;
+  int64_t sim_ns_ = 0;
+  uint64_t contacts_ = 0;
+  sensor_msgs::msg::LaserScan scan_;
+  const bool intra_process_ = this->get_node_options().use_intra_process_comms();
+
+  rclcpp::Publisher<rosgraph_msgs::msg::Clock>::SharedPtr clock_publisher_;
+  rclcpp::Publisher<sensor_msgs::msg::LaserScan>::SharedPtr scan_publisher_;
+  rclcpp::Publisher<std_msgs::msg::Bool>::SharedPtr touched_publisher_;
+  rclcpp::Subscription<geometry_msgs::msg::Twist>::SharedPtr cmd_subscription_;
+};
+
+RCLCPP_COMPONENTS_REGISTER_NODE(WallSim)